@@ -85,6 +85,7 @@ std::string load_file(const std::string& path) {
 #include <imgui.h>
 #include <string>
 #include <functional>
+#include <cstdio>
 
 int nextGroupId = 0; // keep track somewhere in your editor state
 void ShowTwoNumberModal(const char* title, const char* label1, int& a, const char* label2, int& b, std::function<void()> onOk = nullptr)
@@ -210,6 +211,7 @@ void DrawEntity(entt::registry& registry, entt::entity e, Scene& scene)
 			ImGui::DragFloat3("Position##rigidbody", &registry.get<RigidBody>(e).position.x, 0.01f, 0.0f, 1.0f);
 			ImGui::DragFloat3("Velocity", &registry.get<RigidBody>(e).velocity.x, 0.01f, 0.0f, 1.0f);
 			ImGui::Checkbox("IsKinematic", &registry.get<RigidBody>(e).isKinematic);
+			ImGui::Checkbox("IsStatic", &registry.get<RigidBody>(e).isStatic);
 			ImGui::Checkbox("useGravity", &registry.get<RigidBody>(e).useGravity);
 
 			if (ImGui::Button("Remove RigidBody"))
@@ -242,6 +244,18 @@ void DrawEntity(entt::registry& registry, entt::entity e, Scene& scene)
 		{
 			registry.emplace<Collider>(e, ColliderDesc());
 		}
+		if (!registry.any_of<Collider>(e) && registry.any_of<ModelComponent>(e) && ImGui::Button("Add Mesh Collider"))
+		{
+			// Built from the model once it has loaded, triangle meshes only go on static bodies
+			ColliderDesc desc;
+			desc.type = ColliderType::Mesh;
+			registry.emplace<Collider>(e, desc);
+
+			RigidBodyDesc body(registry.get<Transform>(e).position);
+			body.isStatic = true;
+			body.useGravity = false;
+			registry.emplace_or_replace<RigidBody>(e, body);
+		}
 
 
 
@@ -330,9 +344,15 @@ void Application::Run()
 		lastFrame = currentFrame;
 
 		io.DeltaTime = deltaTime;
+
+		// A threaded PhysicsWorld waits while the scene lock is held. It is taken
+		// only around registry writes, physics state reads and the Transform
+		// handoff in update(), input handling and rendering run unlocked.
+		std::unique_lock<std::mutex> sceneLock = m_World.lockScene();
 		scene.script.update(1);
 
-		m_World.stepSimulation(.016f);
+		m_World.update(deltaTime);
+		sceneLock.unlock();
 
 
 
@@ -387,23 +407,41 @@ void Application::Run()
 		else
 		{
 
-			if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_W) == GLFW_PRESS)
-				scene.GetCamera().ProcessKeyboard_Player(FORWARD, deltaTime);
-			if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_S) == GLFW_PRESS)
-				scene.GetCamera().ProcessKeyboard_Player(BACKWARD, deltaTime);
-			if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_A) == GLFW_PRESS)
-				scene.GetCamera().ProcessKeyboard_Player(LEFT, deltaTime);
-			if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_D) == GLFW_PRESS)
-				scene.GetCamera().ProcessKeyboard_Player(RIGHT, deltaTime);
+			// Looking straight up or down leaves no horizontal direction, that axis gives no input then
+			auto flatten = [](const glm::vec3& direction) {
+				glm::vec3 flat(direction.x, 0.0f, direction.z);
+				float length = glm::length(flat);
+				return length > 1e-4f ? flat / length : glm::vec3(0.0f);
+				};
 
-			registry.view<Camera, Transform>().each([&](entt::entity, Camera& cam, Transform& trans)
+			// The character controller moves the player, the camera rides along
+			sceneLock.lock();
+			registry.view<PlayerController, Camera>().each([&](entt::entity, PlayerController& player, Camera& cam)
 				{
+					glm::vec3 frontXZ = flatten(cam.Front);
+					glm::vec3 rightXZ = flatten(cam.Right);
+
+					glm::vec3 input(0.0f);
+					if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_W) == GLFW_PRESS)
+						input += frontXZ;
+					if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_S) == GLFW_PRESS)
+						input -= frontXZ;
+					if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_A) == GLFW_PRESS)
+						input -= rightXZ;
+					if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_D) == GLFW_PRESS)
+						input += rightXZ;
+					player.moveInput = glm::length(input) > 0.0f ? glm::normalize(input) : glm::vec3(0.0f);
+					if (glfwGetKey(m_WindowManager.GetWindow(), GLFW_KEY_SPACE) == GLFW_PRESS)
+						player.jumpRequested = true;
+				});
 
-					cam.Position.y -= 1.5f;
-					trans.position = cam.Position;
-					cam.Position.y += 1.5f;
+			m_World.updateCharacters(deltaTime);
 
+			registry.view<Camera, Transform>().each([&](entt::entity, Camera& cam, Transform& trans)
+				{
+					cam.Position = trans.position + glm::vec3(0.0f, 1.5f, 0.0f);
 				});
+			sceneLock.unlock();
 
 
 
@@ -414,6 +452,8 @@ void Application::Run()
 
 		std::filesystem::path path = std::filesystem::current_path().concat("\\Default.sce");
 
+		// The ECS panel creates, destroys and edits components in place
+		sceneLock.lock();
 		ImGui::Begin("ECS");
 		if (ImGui::Button("Save"))
 		{
@@ -685,6 +725,7 @@ void Application::Run()
 			});
 
 		ImGui::End();
+		sceneLock.unlock();
 
 
 
@@ -766,7 +807,9 @@ void Application::Run()
 			{
 				std::string pathStr = filepath;
 
+				sceneLock.lock();
 				scene.CreateModel(filepath, glm::vec4(1.0f));
+				sceneLock.unlock();
 				ImGui::CloseCurrentPopup();
 			}
 
@@ -797,6 +840,52 @@ void Application::Run()
 
 		ImGui::End();
 
+		ImGui::Begin("Physics Stats");
+		{
+			// Copied under the scene lock, a threaded world writes these every step
+			sceneLock.lock();
+			const PhysicsStats stats = m_World.getStats();
+			sceneLock.unlock();
+
+			static float stepHistory[120] = {};
+			static int historyOffset = 0;
+			static uint64_t lastStep = 0;
+			if (stats.stepCount != lastStep) {
+				lastStep = stats.stepCount;
+				stepHistory[historyOffset] = stats.stepMs;
+				historyOffset = (historyOffset + 1) % IM_ARRAYSIZE(stepHistory);
+			}
+
+#if !PHYSICS_ENABLE_STATS
+			ImGui::TextDisabled("Built with PHYSICS_ENABLE_STATS=0");
+#endif
+			ImGui::Text("Step %.3f ms (#%llu)", stats.stepMs, static_cast<unsigned long long>(stats.stepCount));
+			ImGui::PlotLines("##StepHistory", stepHistory, IM_ARRAYSIZE(stepHistory), historyOffset, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+			if (ImGui::BeginTable("PhysicsPhases", 2, ImGuiTableFlags_RowBg)) {
+				for (size_t phase = 0; phase < static_cast<size_t>(PhysicsPhase::Count); ++phase) {
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(getPhaseName(static_cast<PhysicsPhase>(phase)));
+					ImGui::TableNextColumn();
+					float fraction = stats.stepMs > 0.0f ? stats.phaseMs[phase] / stats.stepMs : 0.0f;
+					char label[32];
+					snprintf(label, sizeof(label), "%.3f ms", stats.phaseMs[phase]);
+					ImGui::ProgressBar(fraction, ImVec2(-1, 0), label);
+				}
+				ImGui::EndTable();
+			}
+
+			ImGui::Separator();
+			ImGui::Text("Bodies: %u (%u awake)", stats.bodies, stats.awakeBodies);
+			ImGui::Text("Proxies: %u (%u moved), cells: %u", stats.proxies, stats.movedProxies, stats.cells);
+			ImGui::Text("Candidate pairs: %u", stats.candidatePairs);
+			ImGui::Text("Contacts: %u, triggers: %u, events: %u", stats.contacts, stats.triggerContacts, stats.events);
+			ImGui::Text("Solver islands: %u, colours: %u", stats.solverIslands, stats.solverColors);
+			ImGui::Text("Memory: %.1f KB (+%.1f KB this step)", stats.memoryBytes / 1024.0f, stats.allocatedBytes / 1024.0f);
+		}
+		ImGui::End();
+
 		ImGui::End(); // end dockspace
 
 
@@ -826,7 +915,9 @@ void Application::Run()
 			if (m_Input.IsMouseButtonPressed(GLFW_MOUSE_BUTTON_1))
 			{
 				//shoot bullet
+				sceneLock.lock();
 				scene.CreateBullet();
+				sceneLock.unlock();
 			}
 		}
 
@@ -844,6 +935,7 @@ void Application::Run()
 
 		if (ImGui::BeginPopupContextWindow("Context"))
 		{
+			sceneLock.lock();
 			if (ImGui::BeginMenu("Spawn"))
 			{
 				if (ImGui::BeginMenu("Shapes"))
@@ -876,6 +968,7 @@ void Application::Run()
 				ImGui::EndMenu();
 			}
 
+			sceneLock.unlock();
 			ImGui::EndPopup();
 		}
 
@@ -1005,6 +1098,10 @@ void Application::Run()
 		}
 
 	}
+
+	// The scene goes out of scope here, stop any physics thread still using it
+	// and detach so the world's destructor doesn't touch its registry
+	m_World.SetScene(nullptr);
 }
 
 
@@ -0,0 +1,45 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box used by the broadphase and scene queries
+struct AABB {
+    glm::vec3 min{ 0.0f };
+    glm::vec3 max{ 0.0f };
+
+    AABB() = default;
+    AABB(const glm::vec3& minPoint, const glm::vec3& maxPoint)
+        : min(minPoint), max(maxPoint) {
+    }
+
+    static AABB fromCenterExtents(const glm::vec3& center, const glm::vec3& halfExtents) {
+        return AABB(center - halfExtents, center + halfExtents);
+    }
+
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 getExtents() const { return (max - min) * 0.5f; }
+
+    // Half the surface area is enough to compare insertion costs
+    float getPerimeter() const {
+        glm::vec3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    bool contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+            other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    bool overlaps(const AABB& other) const {
+        return !(max.x < other.min.x || min.x > other.max.x ||
+            max.y < other.min.y || min.y > other.max.y ||
+            max.z < other.min.z || min.z > other.max.z);
+    }
+
+    AABB expanded(float margin) const {
+        return AABB(min - glm::vec3(margin), max + glm::vec3(margin));
+    }
+
+    static AABB merge(const AABB& a, const AABB& b) {
+        return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <AABB.hpp>
+#include <BodyStore.hpp>
+
+// Boxes packed as six min/max arrays so one box can be tested against a
+// whole SIMD block at once. Arrays grow a block at a time like BodyStore,
+// padding lanes hold an inverted box that overlaps nothing.
+class AABBBatch {
+public:
+    void clear();
+
+    size_t add(const AABB& aabb);
+    void set(size_t index, const AABB& aabb);
+    // Moves the last box into index
+    void removeSwap(size_t index);
+    size_t size() const { return m_count; }
+    AABB get(size_t index) const;
+
+    // Bit i is set when aabb overlaps box begin + i, for the kSimdWidth boxes
+    // starting at begin (a multiple of kSimdWidth). Touching counts as overlap,
+    // same as AABB::overlaps.
+    uint32_t overlapMask(const AABB& aabb, size_t begin) const;
+    uint32_t overlapMaskScalar(const AABB& aabb, size_t begin) const;
+
+    // Calls callback(index) for every box overlapping aabb, in index order,
+    // stops when it returns false. Returns false if stopped.
+    template<typename Callback>
+    bool query(const AABB& aabb, Callback&& callback) const;
+
+    size_t getMemoryUsage() const { return minX.capacity() * 6 * sizeof(float); }
+
+    AlignedFloats minX, minY, minZ;
+    AlignedFloats maxX, maxY, maxZ;
+
+private:
+    size_t m_count = 0;
+};
+
+template<typename Callback>
+bool AABBBatch::query(const AABB& aabb, Callback&& callback) const
+{
+    for (size_t begin = 0; begin < m_count; begin += kSimdWidth) {
+        uint32_t mask = overlapMask(aabb, begin);
+        while (mask) {
+            uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+            mask &= mask - 1;
+            if (!callback(begin + lane)) return false;
+        }
+    }
+    return true;
+}
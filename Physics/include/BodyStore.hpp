@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <glm/vec3.hpp>
+
+// Allocator that keeps SoA arrays aligned for full-width SIMD loads
+template<typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* ptr, size_t) {
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+constexpr size_t kSimdWidth = 8;
+constexpr size_t kSimdAlignment = 32;
+
+using AlignedFloats = std::vector<float, AlignedAllocator<float, kSimdAlignment>>;
+
+// Structure-of-arrays rigid body state. Arrays are padded to a multiple of
+// kSimdWidth so kernels never need a scalar tail.
+class BodyStore {
+public:
+    void clear();
+    void reserve(size_t count);
+
+    size_t add(const glm::vec3& position, const glm::vec3& velocity, float mass, bool isKinematic, bool useGravity);
+    size_t size() const { return m_count; }
+
+    glm::vec3 getPosition(size_t index) const { return { px[index], py[index], pz[index] }; }
+    glm::vec3 getVelocity(size_t index) const { return { vx[index], vy[index], vz[index] }; }
+    bool isKinematic(size_t index) const { return testBit(m_kinematicBits, index); }
+    bool usesGravity(size_t index) const { return testBit(m_gravityBits, index); }
+
+    // Semi-implicit Euler split in two so the contact solver can run between
+    // the halves. Both use the widest kernel the CPU supports.
+    void integrateVelocities(float dt, float gravity);
+    void integratePositions(float dt, float floorY);
+    // Both halves back to back, without a solver in between
+    void integrate(float dt, float gravity, float floorY);
+
+    // Reference implementations, produce the same results as the SIMD kernels
+    void integrateVelocitiesScalar(float dt, float gravity);
+    void integratePositionsScalar(float dt, float floorY);
+    void integrateScalar(float dt, float gravity, float floorY);
+
+    size_t getMemoryUsage() const;
+
+    AlignedFloats px, py, pz;
+    AlignedFloats vx, vy, vz;
+    AlignedFloats invMass;
+
+private:
+    static bool testBit(const std::vector<uint64_t>& bits, size_t index) {
+        return (bits[index >> 6] >> (index & 63)) & 1u;
+    }
+    static void setBit(std::vector<uint64_t>& bits, size_t index, bool value) {
+        if (value) bits[index >> 6] |= (uint64_t(1) << (index & 63));
+        else bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    }
+
+    // 8 lane mask of bodies that receive gravity (useGravity && !isKinematic)
+    uint32_t gravityMask(size_t first) const {
+        uint64_t word = m_gravityBits[first >> 6] & ~m_kinematicBits[first >> 6];
+        return static_cast<uint32_t>((word >> (first & 63)) & 0xFFu);
+    }
+
+    void integrateVelocitiesSimd(float dt, float gravity);
+    void integratePositionsSimd(float dt, float floorY);
+
+    size_t m_count = 0;
+    std::vector<uint64_t> m_kinematicBits;
+    std::vector<uint64_t> m_gravityBits;
+};
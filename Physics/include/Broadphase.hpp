@@ -0,0 +1,171 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DynamicTree.hpp>
+#include <HierarchicalGrid.hpp>
+#include <StaticTree.hpp>
+#include <SweepAndPrune.hpp>
+#include <Collider.hpp>
+
+class TaskPool;
+
+// Ordered 64-bit key for an unordered pair of ids
+inline uint64_t makePairId(uint32_t a, uint32_t b)
+{
+    uint32_t smaller = a < b ? a : b;
+    uint32_t larger = a < b ? b : a;
+    return (static_cast<uint64_t>(smaller) << 32) | static_cast<uint64_t>(larger);
+}
+inline uint32_t pairFirst(uint64_t pairId) { return static_cast<uint32_t>(pairId >> 32); }
+inline uint32_t pairSecond(uint64_t pairId) { return static_cast<uint32_t>(pairId & 0xFFFFFFFFu); }
+
+// Static proxies live in their own tree and carry this bit in their id. It
+// keeps them above every dynamic id, so they always sort second in a pair.
+constexpr int32_t kStaticProxyBit = 0x40000000;
+inline bool isStaticProxy(int32_t proxyId) { return proxyId >= 0 && (proxyId & kStaticProxyBit) != 0; }
+inline int32_t getStaticIndex(int32_t proxyId) { return proxyId & ~kStaticProxyBit; }
+
+// Per proxy data for users of the broadphase. Static proxies get their own
+// array so the bit in their id doesn't stretch the dynamic one.
+template<typename T>
+struct ProxyTable {
+    std::vector<T> dynamicEntries; // indexed by proxy id
+    std::vector<T> staticEntries;  // indexed by static index
+
+    T& operator[](int32_t proxyId) {
+        return isStaticProxy(proxyId) ? staticEntries[getStaticIndex(proxyId)] : dynamicEntries[proxyId];
+    }
+    const T& operator[](int32_t proxyId) const {
+        return isStaticProxy(proxyId) ? staticEntries[getStaticIndex(proxyId)] : dynamicEntries[proxyId];
+    }
+
+    // Grows the matching array so proxyId is a valid index
+    void reserveEntry(int32_t proxyId, const T& value = T()) {
+        std::vector<T>& entries = isStaticProxy(proxyId) ? staticEntries : dynamicEntries;
+        size_t index = static_cast<size_t>(getStaticIndex(proxyId));
+        if (index >= entries.size()) {
+            entries.resize(index + 1, value);
+        }
+    }
+
+    size_t getMemoryUsage() const {
+        return (dynamicEntries.capacity() + staticEntries.capacity()) * sizeof(T);
+    }
+};
+
+// How pairs between dynamic proxies are found. Only HierarchicalGrid tests
+// candidates in packed blocks (AABBBatch, one box against eight at a time).
+// The tree tests one node box per visit and sweep-and-prune finds overlaps
+// from endpoint swaps, so neither has a one-vs-many test to batch.
+enum class BroadphaseType {
+    DynamicTree,
+    SweepAndPrune,
+    HierarchicalGrid
+};
+
+// Persistent broadphase: proxies live across steps and only the ones that
+// left their fat AABB are queried for new pairs. The tree always stores the
+// dynamic proxies, the type only selects how pairs are generated between
+// them. Static proxies sit in an immutable tree that moved dynamic proxies
+// query, so static geometry is never reinserted and never pairs with itself.
+class Broadphase {
+public:
+    Broadphase() = default;
+
+    void setType(BroadphaseType type);
+    BroadphaseType getType() const { return m_type; }
+
+    // --- Proxy management ---
+    int32_t createProxy(const AABB& aabb, uint32_t userData, uint32_t layer = 1u, uint32_t mask = 0xFFFFFFFFu);
+    void destroyProxy(int32_t proxyId);
+    void moveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement);
+
+    // Static proxies can't move, destroy and recreate them instead. Creating or
+    // destroying any rebuilds the static tree on the next updatePairs().
+    int32_t createStaticProxy(const AABB& aabb, uint32_t userData, uint32_t layer = 1u, uint32_t mask = 0xFFFFFFFFu);
+
+    // Pairs failing the layer/mask test are never generated. Changing the
+    // filter drops the proxy's pairs and finds them again on the next update.
+    void setProxyFilter(int32_t proxyId, uint32_t layer, uint32_t mask);
+    uint32_t getLayer(int32_t proxyId) const { return getFilter(proxyId).layer; }
+    uint32_t getMask(int32_t proxyId) const { return getFilter(proxyId).mask; }
+
+    // Finds pairs for moved proxies and drops pairs whose fat AABBs separated.
+    // Tree queries are spread over the pool when one is given.
+    void updatePairs(TaskPool* pool = nullptr);
+
+    // Sorted pair keys of proxy ids whose fat AABBs overlap. Pairs of destroyed
+    // proxies stay in until the next updatePairs().
+    const std::vector<uint64_t>& getPairs() const { return m_pairs; }
+
+    // Pairs that entered or left the set during the last updatePairs().
+    // Pairs of destroyed proxies are dropped without being reported.
+    const std::vector<uint64_t>& getAddedPairs() const { return m_addedPairs; }
+    const std::vector<uint64_t>& getRemovedPairs() const { return m_removedPairs; }
+
+    uint32_t getUserData(int32_t proxyId) const {
+        return isStaticProxy(proxyId) ? m_staticTree.getUserData(getStaticIndex(proxyId)) : m_tree.getUserData(proxyId);
+    }
+    const AABB& getFatAABB(int32_t proxyId) const {
+        return isStaticProxy(proxyId) ? m_staticTree.getAABB(getStaticIndex(proxyId)) : m_tree.getFatAABB(proxyId);
+    }
+    const DynamicTree& getTree() const { return m_tree; }
+    const StaticTree& getStaticTree() const { return m_staticTree; }
+    int32_t getProxyCount() const { return m_tree.getProxyCount() + m_staticTree.getProxyCount(); }
+    // Grid cells in grid mode, tree nodes otherwise, static tree nodes included
+    int32_t getCellCount() const {
+        int32_t dynamicCells = m_type == BroadphaseType::HierarchicalGrid ? m_grid.getCellCount() : m_tree.getNodeCount();
+        return dynamicCells + m_staticTree.getNodeCount();
+    }
+    const HierarchicalGrid& getGrid() const { return m_grid; }
+    size_t getMoveCount() const { return m_moveBuffer.size(); }
+    size_t getMemoryUsage() const;
+
+private:
+    struct ProxyFilter {
+        uint32_t layer;
+        uint32_t mask;
+    };
+
+    const ProxyFilter& getFilter(int32_t proxyId) const {
+        return isStaticProxy(proxyId) ? m_staticFilters[getStaticIndex(proxyId)] : m_filters[proxyId];
+    }
+    ProxyFilter& getFilter(int32_t proxyId) {
+        return isStaticProxy(proxyId) ? m_staticFilters[getStaticIndex(proxyId)] : m_filters[proxyId];
+    }
+    bool passesFilter(int32_t proxyA, int32_t proxyB) const {
+        const ProxyFilter& a = getFilter(proxyA);
+        const ProxyFilter& b = getFilter(proxyB);
+        return shouldCollide(a.layer, a.mask, b.layer, b.mask);
+    }
+
+    void bufferMove(int32_t proxyId);
+    void queryMovedPairs(TaskPool* pool);
+    void queryStaticPairs(int32_t queryProxy, std::vector<uint64_t>& output) const;
+    void queryCreatedStatic();
+    void requeryFiltered();
+    void removeSeparatedPairs();
+    void applyPairDeltas();
+    void linkPair(uint64_t pairId);
+    void unlinkPair(int32_t proxyId, uint64_t pairId);
+    void dropProxyPairs(int32_t proxyId);
+
+    BroadphaseType m_type = BroadphaseType::DynamicTree;
+    DynamicTree m_tree;
+    SweepAndPrune m_sap;
+    HierarchicalGrid m_grid;
+    StaticTree m_staticTree;
+
+    std::vector<ProxyFilter> m_filters; // indexed by proxy id
+    std::vector<ProxyFilter> m_staticFilters; // indexed by static index
+    std::vector<int32_t> m_createdStatic; // static proxies without pairs yet
+    std::vector<int32_t> m_moveBuffer;
+    std::vector<int32_t> m_filterBuffer; // proxies whose filter changed
+    std::vector<uint64_t> m_pairs;
+    ProxyTable<std::vector<uint64_t>> m_proxyPairs; // pairs of each proxy, so updates only visit moved ones
+    std::vector<uint64_t> m_droppedPairs; // leave m_pairs on the next update
+    std::vector<uint64_t> m_addedPairs;
+    std::vector<uint64_t> m_removedPairs;
+    std::vector<uint64_t> m_mergeBuffer;
+    std::vector<std::vector<uint64_t>> m_chunkPairs;
+};
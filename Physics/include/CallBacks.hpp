@@ -1,13 +1,21 @@
 #pragma once
 #include <functional>
 #include <cstdint>
+#include <span>
+#include <ContactEvents.hpp>
 
+// Slot map handles for world owned bodies and colliders. Callbacks and
+// queries report entities instead, see PhysicsWorld::getEntity().
 using RigidBodyID = uint32_t;
 using ColliderID = uint32_t;
 
-// Collision callback signature
-using CollisionCallback = std::function<void(RigidBodyID a, RigidBodyID b)>;
+// Collision callback signature, toi is the fraction of the step at which they touched.
+// b is null for the floor.
+using CollisionCallback = std::function<void(entt::entity a, entt::entity b, float toi)>;
 
 // Trigger callback signature
-using TriggerCallback = std::function<void(RigidBodyID a, ColliderID trigger)>;
+using TriggerCallback = std::function<void(entt::entity body, entt::entity trigger)>;
+
+// Receives the whole event buffer once per step
+using ContactEventCallback = std::function<void(std::span<const ContactEvent> events)>;
 
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+// Upright capsule moved by PhysicsWorld::moveCharacter(). It never becomes a
+// broadphase proxy, so it costs a few tree queries per move instead of
+// taking part in pair generation and the contact solver. Bodies don't react
+// to it, it only slides along them.
+struct CharacterDesc {
+    float radius = 0.4f;
+    float halfHeight = 0.6f;      // half length of the segment between the two caps
+    float skinWidth = 0.02f;      // gap kept to every surface
+    float maxSlopeCos = 0.7f;     // surfaces at least this upright count as ground
+    uint32_t layer = 1u;          // collision layer bits, see Collider
+    uint32_t mask = 0xFFFFFFFFu;
+};
+
+struct CharacterMoveResult {
+    glm::vec3 position{ 0.0f };
+    glm::vec3 groundNormal{ 0.0f, 1.0f, 0.0f };
+    bool isGrounded = false;
+    bool hitCeiling = false;      // a downward facing surface stopped the move
+    uint32_t hits = 0;            // surfaces the move slid along
+};
@@ -1,27 +1,56 @@
 #pragma once
 #include <cstdint>
 #include <glm/vec3.hpp>
+#include <TriangleMesh.hpp>
 
 
 enum class ColliderType {
     Box,
     Sphere,
-    Capsule
+    Capsule,
+    Mesh     // static only, see Collider::mesh
 };
 
+// Two colliders only interact when each one's layer is in the other's mask
+inline bool shouldCollide(uint32_t layerA, uint32_t maskA, uint32_t layerB, uint32_t maskB)
+{
+    return (layerA & maskB) != 0 && (layerB & maskA) != 0;
+}
+
 struct ColliderDesc {
     ColliderType type = ColliderType::Box;
-    glm::vec3 size{ 1.0f, 1.0f, 1.0f };   // half-extents for box, radius for sphere, etc.
+    glm::vec3 size{ 1.0f, 1.0f, 1.0f };   // box extents, sphere/capsule diameter in x, capsule height in y
     glm::vec3 offset{ 0.0f };             // local offset from parent rigid body
+    float friction = 0.5f;
+    bool isTrigger = false;               // reports events but never pushes back
+    uint32_t layer = 1u;                  // bits this collider is on
+    uint32_t mask = 0xFFFFFFFFu;          // layers it collides with
+    TriangleMeshFuture mesh;              // Mesh triangles in body space, size is ignored
 };
 
 class Collider {
 public:
     Collider(const ColliderDesc& desc)
-        : type(desc.type), size(desc.size), offset(desc.offset) {
+        : type(desc.type), size(desc.size), offset(desc.offset), friction(desc.friction), isTrigger(desc.isTrigger),
+        layer(desc.layer), mask(desc.mask), mesh(desc.mesh) {
     }
 
+    // Built mesh of a Mesh collider, nullptr while the build is still running
+    const TriangleMesh* getMesh() const { return mesh.get(); }
+
     ColliderType type;
     glm::vec3 size;
     glm::vec3 offset;
+    float friction;
+    bool isTrigger;
+    uint32_t layer;
+    uint32_t mask;
+    // Mesh colliders only take part once the mesh is built and only on static
+    // bodies. On entities with a ModelComponent the world starts the build
+    // from the loaded model when this is left empty, and builds it again
+    // when the Transform scale changes.
+    TriangleMeshFuture mesh;
+
+    // Broadphase proxy owned by the PhysicsWorld, -1 until first step
+    int32_t proxyId = -1;
 };
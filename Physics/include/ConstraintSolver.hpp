@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <ContactCache.hpp>
+#include <IslandManager.hpp>
+
+class BodyStore;
+class TaskPool;
+
+// Sequential impulse contact solver working directly on the BodyStore
+// velocities. Accumulated impulses from the contact cache are applied first
+// (warm starting), so resting stacks start each step close to the answer.
+//
+// Contacts are split into islands that share no moving body. Islands are
+// solved side by side on the task pool, each in contact order. Large islands
+// are graph coloured instead, a colour never touches a body twice, so its
+// contacts run in parallel. Both layouts only depend on the contacts, the
+// results are the same whatever the thread count.
+class ConstraintSolver {
+public:
+    void setIterations(uint32_t iterations) { m_iterations = iterations; }
+    uint32_t getIterations() const { return m_iterations; }
+
+    void setWarmStarting(bool enabled) { m_warmStarting = enabled; }
+    bool getWarmStarting() const { return m_warmStarting; }
+
+    void solve(std::vector<ContactManifold>& manifolds, BodyStore& bodies, float dt, TaskPool& pool);
+
+    // Layout of the last solve
+    uint32_t getIslandCount() const { return static_cast<uint32_t>(m_islands.size() + m_largeIslands.size()); }
+    uint32_t getColorCount() const { return static_cast<uint32_t>(m_colors.size()); }
+
+private:
+    // Contacts m_order[begin, end)
+    struct Batch {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        bool serial = false;  // colour overflow, bodies may repeat
+    };
+    // Colours m_colors[begin, end) of one large island
+    using ColorRange = Batch;
+
+    void prepare(std::vector<ContactManifold>& manifolds, const BodyStore& bodies, float dt, TaskPool& pool);
+    void buildIslands(const std::vector<ContactManifold>& manifolds, size_t bodyCount);
+    void colorIsland(const std::vector<ContactManifold>& manifolds, const Batch& island);
+    void warmStart(const std::vector<ContactManifold>& manifolds, BodyStore& bodies, uint32_t begin, uint32_t end);
+    void solveVelocities(std::vector<ContactManifold>& manifolds, BodyStore& bodies, uint32_t begin, uint32_t end);
+
+    uint32_t m_iterations = 8;
+    bool m_warmStarting = true;
+
+    IslandManager m_graph;
+    std::vector<uint32_t> m_order;        // manifold indices grouped by island, then colour
+    std::vector<Batch> m_islands;         // islands solved whole by one task
+    std::vector<ColorRange> m_largeIslands;
+    std::vector<Batch> m_colors;
+
+    // Scratch for buildIslands()
+    std::vector<int32_t> m_islandOfRoot;
+    std::vector<int32_t> m_contactIsland;
+    std::vector<uint32_t> m_islandOffsets;
+    std::vector<uint64_t> m_bodyColors;     // bit per colour already used by the body
+    std::vector<uint8_t> m_contactColors;
+    std::vector<uint32_t> m_colorOffsets;
+    std::vector<uint32_t> m_colorScratch;
+};
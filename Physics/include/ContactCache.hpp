@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec3.hpp>
+
+// Contact between two bodies. Bodies have no rotation, so a single point
+// (normal + separation) describes the whole manifold.
+struct ContactManifold {
+    uint64_t pairId = 0;          // ordered proxy pair key from the broadphase
+    uint32_t entityA = 0;         // owners, guard against recycled proxy ids
+    uint32_t entityB = 0;
+    int32_t bodyA = -1;           // BodyStore slots, -1 acts as static this step
+    int32_t bodyB = -1;
+
+    glm::vec3 normal{ 0.0f, 1.0f, 0.0f }; // from A to B
+    float separation = 0.0f;      // negative while penetrating
+    float friction = 0.5f;
+    bool asleep = false;          // both bodies asleep, narrowphase skipped
+    bool isTrigger = false;       // overlap only, never solved
+
+    // Accumulated impulses, carried between steps for warm starting
+    float normalImpulse = 0.0f;
+    float tangentImpulse[2] = { 0.0f, 0.0f };
+
+    // Solver scratch, rebuilt every step
+    glm::vec3 tangent[2];
+    float effectiveMass = 0.0f;
+    float targetVelocity = 0.0f;
+};
+
+// Persistent manifolds sorted by pair id. Each step the fresh narrowphase
+// output is merged in and inherits the impulses of the matching old manifold.
+class ContactCache {
+public:
+    // contacts must be sorted by pairId. Asleep entries carry no geometry
+    // and keep their old manifold as is.
+    void update(std::vector<ContactManifold>& contacts);
+    void clear() { m_manifolds.clear(); }
+
+    std::vector<ContactManifold>& getManifolds() { return m_manifolds; }
+    const std::vector<ContactManifold>& getManifolds() const { return m_manifolds; }
+
+    size_t getMemoryUsage() const { return (m_manifolds.capacity() + m_previous.capacity()) * sizeof(ContactManifold); }
+
+private:
+    std::vector<ContactManifold> m_manifolds;
+    std::vector<ContactManifold> m_previous;
+};
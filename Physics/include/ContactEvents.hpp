@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+enum class ContactEventType : uint8_t {
+    Begin,
+    Stay,
+    End
+};
+
+// One entry of the per-step event buffer
+struct ContactEvent {
+    ContactEventType type = ContactEventType::Begin;
+    bool isTrigger = false;        // entityA is the trigger
+    bool isProjectile = false;     // a pooled projectile fired by entityA (may be null) hit entityB
+    entt::entity entityA = entt::null;
+    entt::entity entityB = entt::null; // null for the floor
+    glm::vec3 normal{ 0.0f };      // from A to B, zero for End
+    float toi = 0.0f;              // fraction of the step for swept bullet hits, 0 otherwise
+};
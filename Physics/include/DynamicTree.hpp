@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <AABB.hpp>
+
+constexpr int32_t kNullNode = -1;
+
+// Leaves store a fattened AABB so small motions don't need a reinsert
+constexpr float kAABBMargin = 0.1f;
+// Fat AABBs are also stretched along the predicted displacement
+constexpr float kAABBDisplacementMultiplier = 4.0f;
+
+struct TreeNode {
+    bool isLeaf() const { return child1 == kNullNode; }
+
+    AABB aabb;
+    uint32_t userData = 0;
+
+    // Parent while in the tree, next free node while on the free list
+    int32_t parent = kNullNode;
+    int32_t child1 = kNullNode;
+    int32_t child2 = kNullNode;
+
+    // Leaf = 0, free node = -1
+    int32_t height = -1;
+
+    bool moved = false;
+};
+
+// Small fixed stack for tree traversal that only touches the heap on deep trees
+class TreeStack {
+public:
+    void push(int32_t value) {
+        if (m_count < kInlineSize) {
+            m_inline[m_count] = value;
+        }
+        else {
+            m_overflow.push_back(value);
+        }
+        ++m_count;
+    }
+
+    int32_t pop() {
+        --m_count;
+        if (m_count < kInlineSize) {
+            return m_inline[m_count];
+        }
+        int32_t value = m_overflow.back();
+        m_overflow.pop_back();
+        return value;
+    }
+
+    bool empty() const { return m_count == 0; }
+
+private:
+    static constexpr int32_t kInlineSize = 256;
+    int32_t m_inline[kInlineSize];
+    std::vector<int32_t> m_overflow;
+    int32_t m_count = 0;
+};
+
+// Incrementally updated bounding volume hierarchy of fattened AABBs
+class DynamicTree {
+public:
+    DynamicTree();
+
+    // --- Proxy management ---
+    int32_t createProxy(const AABB& aabb, uint32_t userData);
+    void destroyProxy(int32_t proxyId);
+
+    // Returns true only if the proxy left its fat AABB and was reinserted
+    bool moveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement);
+
+    const AABB& getFatAABB(int32_t proxyId) const { return m_nodes[proxyId].aabb; }
+    uint32_t getUserData(int32_t proxyId) const { return m_nodes[proxyId].userData; }
+    bool wasMoved(int32_t proxyId) const { return m_nodes[proxyId].moved; }
+    void clearMoved(int32_t proxyId) { m_nodes[proxyId].moved = false; }
+
+    // --- Queries ---
+    // Calls callback(proxyId) for every leaf overlapping aabb, stops when it returns false
+    template<typename Callback>
+    void query(const AABB& aabb, Callback&& callback) const;
+
+    // Calls callback(proxyId, maxDistance) for every leaf whose fat AABB the
+    // ray enters before maxDistance. The callback returns the new maxDistance
+    // (the hit distance to keep the closest hit, 0 to stop). A radius turns
+    // the ray into a swept sphere against boxes inflated by that radius.
+    template<typename Callback>
+    void rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback, float radius = 0.0f) const;
+
+    // Calls callback(proxyId) for every leaf
+    template<typename Callback>
+    void forEachProxy(Callback&& callback) const {
+        for (int32_t i = 0; i < static_cast<int32_t>(m_nodes.size()); ++i) {
+            if (m_nodes[i].height == 0) callback(i);
+        }
+    }
+
+    // Raw node access for custom traversals such as ray packets
+    int32_t getRoot() const { return m_root; }
+    const TreeNode& getNode(int32_t nodeId) const { return m_nodes[nodeId]; }
+
+    // --- Stats ---
+    int32_t getHeight() const;
+    int32_t getProxyCount() const { return m_proxyCount; }
+    int32_t getNodeCount() const { return m_proxyCount > 0 ? 2 * m_proxyCount - 1 : 0; }
+    size_t getMemoryUsage() const { return m_nodes.capacity() * sizeof(TreeNode); }
+
+private:
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t nodeId);
+
+    std::vector<TreeNode> m_nodes;
+    int32_t m_root = kNullNode;
+    int32_t m_freeList = kNullNode;
+    int32_t m_proxyCount = 0;
+};
+
+template<typename Callback>
+void DynamicTree::query(const AABB& aabb, Callback&& callback) const
+{
+    TreeStack stack;
+    stack.push(m_root);
+
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        if (nodeId == kNullNode) continue;
+
+        const TreeNode& node = m_nodes[nodeId];
+        if (!node.aabb.overlaps(aabb)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(nodeId)) return;
+        }
+        else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicTree::rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback, float radius) const
+{
+    // Zero components become huge instead of infinite so 0 * inf can't produce NaN
+    glm::vec3 invDirection;
+    for (int axis = 0; axis < 3; ++axis) {
+        float d = direction[axis];
+        invDirection[axis] = 1.0f / (d != 0.0f ? d : 1e-20f);
+    }
+
+    TreeStack stack;
+    stack.push(m_root);
+
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        if (nodeId == kNullNode) continue;
+
+        const TreeNode& node = m_nodes[nodeId];
+        glm::vec3 t1 = (node.aabb.min - radius - origin) * invDirection;
+        glm::vec3 t2 = (node.aabb.max + radius - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t1, t2);
+        glm::vec3 tFar = glm::max(t1, t2);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        if (enter > exit) continue;
+
+        if (node.isLeaf()) {
+            maxDistance = callback(nodeId, maxDistance);
+            if (maxDistance <= 0.0f) return;
+        }
+        else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
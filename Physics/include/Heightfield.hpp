@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <AABB.hpp>
+
+struct HeightfieldDesc {
+    glm::vec3 origin{ 0.0f };  // world position of the first sample, black pixels sit at origin.y
+    float spacing = 1.0f;      // distance between samples along x and z
+    float heightScale = 10.0f; // height of a white pixel above origin.y
+};
+
+// Regular grid of heights over the xz plane, each cell split into two
+// triangles along its diagonal. Finding the cell under a point takes two
+// divisions, so ground queries cost the same however large the terrain is.
+// Points outside the grid use the nearest border sample.
+class Heightfield {
+public:
+    Heightfield() = default;
+    // heights holds columns * rows samples, row by row along +z
+    Heightfield(uint32_t columns, uint32_t rows, std::vector<float> heights, const HeightfieldDesc& desc);
+
+    // Grayscale image through stb_image, one sample per pixel, image rows
+    // along +z. Only the first channel is used. Returns false if it can't be read.
+    bool loadFromImage(const std::string& path, const HeightfieldDesc& desc);
+
+    bool isValid() const { return m_columns >= 2 && m_rows >= 2; }
+
+    // Surface height and upward normal below a point
+    void sample(float x, float z, float& height, glm::vec3& normal) const;
+    float getHeight(float x, float z) const;
+
+    AABB getBounds() const;
+    uint32_t getColumns() const { return m_columns; }
+    uint32_t getRows() const { return m_rows; }
+    size_t getMemoryUsage() const { return m_heights.capacity() * sizeof(float); }
+
+private:
+    float at(uint32_t column, uint32_t row) const { return m_heights[row * m_columns + column]; }
+
+    std::vector<float> m_heights;
+    uint32_t m_columns = 0;
+    uint32_t m_rows = 0;
+    glm::vec3 m_origin{ 0.0f };
+    float m_spacing = 1.0f;
+    float m_invSpacing = 1.0f;
+    float m_minHeight = 0.0f;
+    float m_maxHeight = 0.0f;
+};
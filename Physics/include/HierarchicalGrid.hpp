@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <AABB.hpp>
+#include <AABBBatch.hpp>
+
+// Uniform grids stacked by cell size, each level twice as coarse as the one
+// below. A proxy lives in the finest level whose cells are at least as large
+// as its box, so it touches at most 2 x 2 x 2 cells there. The level sizes
+// follow the spread of proxy sizes and are derived again when the proxies
+// stop fitting them.
+class HierarchicalGrid {
+public:
+    // --- Proxy management (ids are owned by the Broadphase) ---
+    void addProxy(int32_t proxyId, const AABB& aabb);
+    void updateProxy(int32_t proxyId, const AABB& aabb);
+    void removeProxy(int32_t proxyId);
+    void clear();
+
+    // Picks new level sizes and reinserts every proxy when the current ones
+    // no longer fit. Returns true if that happened.
+    bool updateLevels();
+
+    // Calls callback(proxyId) once for every proxy whose box overlaps aabb,
+    // stops when it returns false
+    template<typename Callback>
+    void query(const AABB& aabb, Callback&& callback) const;
+
+    int32_t getLevelCount() const { return static_cast<int32_t>(m_levels.size()); }
+    float getCellSize(int32_t level) const { return m_levels[level].cellSize; }
+    int32_t getCellCount() const { return m_occupiedCells; }
+    size_t getMemoryUsage() const;
+
+private:
+    struct CellCoord {
+        int32_t x, y, z;
+        bool operator==(const CellCoord& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    // bounds[i] is the box of proxies[i], packed for one-vs-block tests
+    struct Cell {
+        CellCoord coord;
+        std::vector<int32_t> proxies;
+        AABBBatch bounds;
+    };
+
+    // Empty cells are kept so moving proxies don't reallocate, see updateLevels()
+    struct Level {
+        float cellSize = 1.0f;
+        float invCellSize = 1.0f;
+        std::unordered_map<uint64_t, Cell> cells;
+        int32_t proxyCount = 0;
+    };
+
+    struct Box {
+        AABB aabb;
+        int32_t level = -1; // -1 until placed
+        CellCoord minCell{};
+        CellCoord maxCell{};
+        bool active = false;
+    };
+
+    static uint64_t makeCellKey(const CellCoord& coord);
+    static CellCoord getCell(const Level& level, const glm::vec3& point);
+    static float getSize(const AABB& aabb);
+    bool outgrowsLevels(const AABB& aabb) const;
+    int32_t pickLevel(const AABB& aabb) const;
+    void insert(int32_t proxyId);
+    void erase(int32_t proxyId);
+
+    std::vector<Level> m_levels;
+    std::vector<Box> m_boxes; // indexed by proxy id
+    int32_t m_proxyCount = 0;
+    int32_t m_layoutProxyCount = 0; // proxies when the levels were last derived
+    int32_t m_occupiedCells = 0;
+    size_t m_cellEntries = 0; // proxy ids stored over all cells
+    size_t m_boundsBytes = 0; // capacity of every cell's packed bounds, empty cells included
+    bool m_levelsDirty = true;
+};
+
+template<typename Callback>
+void HierarchicalGrid::query(const AABB& aabb, Callback&& callback) const
+{
+    for (const Level& level : m_levels) {
+        if (level.proxyCount == 0) continue;
+
+        CellCoord lo = getCell(level, aabb.min);
+        CellCoord hi = getCell(level, aabb.max);
+
+        // A proxy spanning several cells is reported only from the cell holding
+        // the min corner of its overlap with the query
+        auto visitCell = [&](const Cell& cell) {
+            return cell.bounds.query(aabb, [&](size_t index) {
+                int32_t proxyId = cell.proxies[index];
+                if (!(getCell(level, glm::max(aabb.min, m_boxes[proxyId].aabb.min)) == cell.coord)) return true;
+                return static_cast<bool>(callback(proxyId));
+                });
+            };
+
+        // Large queries against fine levels walk the occupied cells instead of the range
+        uint64_t rangeCells = static_cast<uint64_t>(hi.x - lo.x + 1) * static_cast<uint64_t>(hi.y - lo.y + 1) *
+            static_cast<uint64_t>(hi.z - lo.z + 1);
+        if (rangeCells > level.cells.size()) {
+            for (const auto& [key, cell] : level.cells) {
+                const CellCoord& c = cell.coord;
+                if (c.x < lo.x || c.x > hi.x || c.y < lo.y || c.y > hi.y || c.z < lo.z || c.z > hi.z) continue;
+                if (!visitCell(cell)) return;
+            }
+            continue;
+        }
+
+        for (int32_t x = lo.x; x <= hi.x; ++x) {
+            for (int32_t y = lo.y; y <= hi.y; ++y) {
+                for (int32_t z = lo.z; z <= hi.z; ++z) {
+                    auto it = level.cells.find(makeCellKey({ x, y, z }));
+                    if (it == level.cells.end()) continue;
+                    if (!visitCell(it->second)) return;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Groups awake bodies into islands through their contacts (union-find over
+// the step's dense body indices) and remembers the members of islands that
+// went to sleep so a single touch can wake all of them.
+class IslandManager {
+public:
+    // --- Per-step contact graph ---
+    void begin(size_t bodyCount);
+    void link(int32_t bodyA, int32_t bodyB);
+    int32_t find(int32_t body);
+
+    // --- Sleeping islands ---
+    int32_t createSleepingIsland();
+    void addToSleepingIsland(int32_t islandId, uint32_t member);
+    void removeFromSleepingIsland(int32_t islandId, uint32_t member);
+    void releaseSleepingIsland(int32_t islandId);
+    const std::vector<uint32_t>& getSleepingIsland(int32_t islandId) const { return m_sleepingIslands[islandId]; }
+
+    // Flat copy of the sleeping islands, island i owns members[offsets[i], offsets[i + 1])
+    void saveSleepingIslands(std::vector<uint32_t>& offsets, std::vector<uint32_t>& members, std::vector<int32_t>& freeIslands) const;
+    void loadSleepingIslands(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& members, const std::vector<int32_t>& freeIslands);
+
+    void clear();
+
+private:
+    std::vector<int32_t> m_parent;
+    std::vector<int32_t> m_rank;
+
+    std::vector<std::vector<uint32_t>> m_sleepingIslands;
+    std::vector<int32_t> m_freeIslands;
+};
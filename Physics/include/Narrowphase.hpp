@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <AABB.hpp>
+#include <Collider.hpp>
+#include <ContactCache.hpp>
+
+// Collider placed in the world for one step
+struct ShapeInstance {
+    ColliderType type = ColliderType::Box;
+    glm::vec3 center{ 0.0f };        // body position + rotated offset
+    glm::mat3 rotation{ 1.0f };      // columns are the local axes
+    glm::vec3 halfExtents{ 0.5f };   // Box
+    float radius = 0.5f;             // Sphere, Capsule
+    float halfHeight = 0.0f;         // Capsule segment half length along local Y
+    const TriangleMesh* mesh = nullptr; // Mesh, kept alive by the collider
+
+    // Box half extents are size * 0.5, spheres and capsules take size.x as the
+    // diameter and capsules size.y as the total height
+    static ShapeInstance fromCollider(const Collider& col, const glm::vec3& position, const glm::vec3& rotationDegrees);
+
+    AABB computeAABB() const;
+
+    // Capsule segment end points
+    glm::vec3 getSegmentA() const { return center - rotation[1] * halfHeight; }
+    glm::vec3 getSegmentB() const { return center + rotation[1] * halfHeight; }
+};
+
+// Same Euler order as the renderer's model matrix (X, then Y, then Z)
+glm::mat3 rotationFromEuler(const glm::vec3& degrees);
+
+// Exact contact between two shapes. Fills normal (from a to b) and separation
+// and returns true if they are closer than maxSeparation. The shape pair
+// picks its closed-form test from a table built at compile time. Against a
+// mesh the deepest triangle gives the contact, two meshes never collide.
+bool collideShapes(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact);
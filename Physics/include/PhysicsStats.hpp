@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Timers and counters compile to nothing with PHYSICS_ENABLE_STATS=0. The
+// struct stays so tools can keep reading it, it just stays zeroed.
+#ifndef PHYSICS_ENABLE_STATS
+#define PHYSICS_ENABLE_STATS 1
+#endif
+
+enum class PhysicsPhase : uint8_t {
+    Integrate,       // gather, both integrator halves, scatter
+    BroadphaseBuild, // proxy creation and fat AABB moves
+    PairGeneration,  // tree/SAP queries for moved proxies
+    Narrowphase,     // shape tests, wake checks, contact cache
+    Solve,           // contact impulses
+    Islands,         // island building and sleeping
+    Queries,         // query bounds and swept bullets
+    Events,          // contact event diffing and callbacks
+    Count
+};
+
+inline const char* getPhaseName(PhysicsPhase phase)
+{
+    static const char* names[] = {
+        "Integrate", "Broadphase build", "Pair generation", "Narrowphase",
+        "Solve", "Islands", "Queries", "Events"
+    };
+    return names[static_cast<size_t>(phase)];
+}
+
+// Numbers of the last fixed step
+struct PhysicsStats {
+    float phaseMs[static_cast<size_t>(PhysicsPhase::Count)] = {};
+    float stepMs = 0.0f;
+    uint64_t stepCount = 0;
+
+    uint32_t bodies = 0;
+    uint32_t awakeBodies = 0;
+    uint32_t proxies = 0;
+    uint32_t movedProxies = 0;   // proxies that left their fat AABB
+    uint32_t cells = 0;          // occupied grid cells or tree nodes, see Broadphase::getCellCount()
+    uint32_t candidatePairs = 0; // broadphase pairs handed to the narrowphase
+    uint32_t contacts = 0;       // manifolds the solver worked on
+    uint32_t triggerContacts = 0;
+    uint32_t solverIslands = 0;  // contact islands solved side by side
+    uint32_t solverColors = 0;   // colour batches of the large islands
+    uint32_t events = 0;
+
+    size_t memoryBytes = 0;      // world owned buffers, see PhysicsWorld::getMemoryUsage()
+    size_t allocatedBytes = 0;   // how much those buffers grew during the step
+};
+
+#if PHYSICS_ENABLE_STATS
+
+// Adds the lifetime of the scope to a millisecond counter
+class PhysicsScopedTimer {
+public:
+    explicit PhysicsScopedTimer(float& target)
+        : m_target(target), m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~PhysicsScopedTimer()
+    {
+        m_target += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    PhysicsScopedTimer(const PhysicsScopedTimer&) = delete;
+    PhysicsScopedTimer& operator=(const PhysicsScopedTimer&) = delete;
+
+private:
+    float& m_target;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#define PHYSICS_STATS_CONCAT_INNER(a, b) a##b
+#define PHYSICS_STATS_CONCAT(a, b) PHYSICS_STATS_CONCAT_INNER(a, b)
+#define PHYSICS_SCOPED_TIMER(stats, phase) \
+    PhysicsScopedTimer PHYSICS_STATS_CONCAT(physicsTimer, __LINE__)((stats).phaseMs[static_cast<size_t>(phase)])
+#define PHYSICS_STAT(statement) statement
+
+#else
+
+#define PHYSICS_SCOPED_TIMER(stats, phase) ((void)0)
+#define PHYSICS_STAT(statement) ((void)0)
+
+#endif
@@ -2,8 +2,33 @@
 #include <RigidBody.hpp>
 #include <Collider.hpp>
 #include <Callbacks.hpp>
+#include <Broadphase.hpp>
+#include <BodyStore.hpp>
+#include <TaskPool.hpp>
+#include <IslandManager.hpp>
+#include <ContactCache.hpp>
+#include <ConstraintSolver.hpp>
+#include <SceneQuery.hpp>
+#include <Narrowphase.hpp>
+#include <TripleBuffer.hpp>
+#include <SlotMap.hpp>
+#include <PhysicsStats.hpp>
+#include <Heightfield.hpp>
+#include <CharacterController.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <Scene.hpp>
 
+// Tags the scene entity standing in for a body owned by PhysicsWorld. Events
+// and queries report this entity, destroying it destroys the body.
+struct WorldBody {
+    RigidBodyID id = kInvalidHandle;
+};
+
 class PhysicsWorld {
 public:
     PhysicsWorld();
@@ -11,36 +36,311 @@ public:
     ~PhysicsWorld();
 
     // --- Simulation ---
+    // Runs as many fixed steps as the frame time allows, then interpolates Transform
+    void update(float frameDeltaTime);
     void stepSimulation(float fixedDeltaTime);
+    // In threaded mode hold lockScene() for these two, the thread picks them up on its next tick
+    void setTickRate(float ticksPerSecond);
+    void setMaxSubsteps(uint32_t maxSubsteps);
+    float getInterpolationAlpha() const { return m_interpolationAlpha; }
+
+    // Steps on a dedicated thread at the tick rate. update() then only copies
+    // the latest published snapshot into Transform, and Transform edits made
+    // on the main thread are forwarded as teleports.
+    void setThreaded(bool threaded);
+    bool isThreaded() const { return m_threaded; }
+    // Held by the physics thread while it steps. Take it around anything that
+    // adds or removes entities/components or reads physics state (queries).
+    std::unique_lock<std::mutex> lockScene();
     void SetScene(Scene* scene);
+    void setBroadphaseType(BroadphaseType type);
+    // Counts the calling thread, 0 uses every hardware thread
+    void setThreadCount(uint32_t threadCount);
+    void setSleepingEnabled(bool enabled);
+    void setSolverIterations(uint32_t iterations);
+    void setWarmStarting(bool enabled);
+    // Terrain the bodies rest on instead of the flat floor at floorHeight. It
+    // is sampled directly under each body, no broadphase proxy involved.
+    // Pass nullptr to go back to the floor. In threaded mode hold lockScene().
+    void setHeightfield(std::shared_ptr<const Heightfield> heightfield);
+    const Heightfield* getHeightfield() const { return m_heightfield.get(); }
+
+    // --- Counters of the last step ---
+    size_t getBodyCount() const { return m_simBodies.size(); }
+    size_t getAwakeBodyCount() const { return m_awakeBodies.size(); }
+    size_t getPairCount() const { return m_broadphase.getPairs().size(); }
+    size_t getContactCount() const { return m_contactCache.getManifolds().size(); }
+    // Bytes held by the world's own buffers, registry storage not included
+    size_t getMemoryUsage() const;
+    // Per-phase timings and counters of the last step. Written by the physics
+    // thread in threaded mode, read it under lockScene().
+    const PhysicsStats& getStats() const { return m_stats; }
 
     // --- Rigid body management ---
-    RigidBody createRigidBody(const RigidBodyDesc& desc);
+    // Bodies and colliders created here are owned by the world and stored
+    // densely in slot maps instead of the registry. Handles stay valid until
+    // destroyed, stale handles resolve to nullptr. Pointers are only good until
+    // the next create or destroy. In threaded mode hold lockScene().
+    RigidBodyID createRigidBody(const RigidBodyDesc& desc);
     void destroyRigidBody(RigidBodyID id);
     RigidBody* getRigidBody(RigidBodyID id);
+    // Entity reported for the body in events and queries
+    entt::entity getEntity(RigidBodyID id) const;
 
     // --- Collider (shape) management ---
-    Collider createCollider(const ColliderDesc& desc);
+    ColliderID createCollider(const ColliderDesc& desc);
+    void destroyCollider(ColliderID id);
+    Collider* getCollider(ColliderID id);
+    // A body carries one collider, attaching replaces the previous one
     void attachCollider(RigidBodyID body, ColliderID collider);
     void detachCollider(RigidBodyID body, ColliderID collider);
+    // Builds a Mesh collider's triangles on the world's task pool
+    TriangleMeshFuture buildTriangleMesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+
+    // --- Queries ---
+    // Closest hit along the ray, against collider boxes as of the last step
+    bool raycast(const Ray& ray, RaycastHit& hit);
+    // Traces rays in SIMD packets over the task pool, hits[i] answers rays[i]
+    void raycastBatch(const Ray* rays, size_t count, RaycastHit* hits);
+    // Bodies whose collider overlaps the shape placed at pose
+    void overlapQuery(const ColliderDesc& shape, const Transform& pose, std::vector<entt::entity>& results);
+
+    // --- Character controllers ---
+    // Sweeps the capsule from position along displacement and slides along
+    // whatever it touches, then keeps it above the floor or terrain. Reads the
+    // shapes of the last step like the other queries, hold lockScene() when threaded.
+    CharacterMoveResult moveCharacter(const CharacterDesc& desc, const glm::vec3& position, const glm::vec3& displacement);
+    // Moves every PlayerController entity by its input, gravity and jumps
+    void updateCharacters(float deltaTime);
+
+    // --- Snapshots ---
+    // Bodies, sleeping islands, the contact cache, touching pairs and the
+    // projectile pool copied into flat arrays of plain records, for rollback
+    // and resetting a scene. Capturing into the same snapshot again reuses
+    // its buffers. Bodies destroyed since the capture stay destroyed and
+    // their contacts are dropped, bodies created since are woken up outside
+    // any island. Broadphase proxies are moved to the restored bodies and
+    // find their pairs again on the next step. Collider settings are not
+    // part of it. In threaded mode hold lockScene().
+    struct Snapshot;
+    void captureSnapshot(Snapshot& snapshot) const;
+    void restoreSnapshot(const Snapshot& snapshot);
 
     // --- Events ---
+    // Begin, stay and end events of the last step, ordered by pair. In threaded
+    // mode callbacks run on the physics thread with the scene lock held.
+    std::span<const ContactEvent> getContactEvents() const { return m_contactEvents; }
+    void setContactEventCallback(ContactEventCallback cb);
+    // Called once per Begin event, after the step
     void setCollisionCallback(CollisionCallback cb);
     void setTriggerCallback(TriggerCallback cb);
 
+    // Calls func(self, other, event, Component&...) for each side of each
+    // event whose entity is alive and has all of Component
+    template<typename... Component, typename Func>
+    void eachContactEvent(Func&& func);
+
 private:
     // --- Internal modules (subsystems) ---
-   // Broadphase           m_broadphase;
-   // Narrowphase          m_narrowphase;
-   // ConstraintSolver     m_solver;
+    Broadphase           m_broadphase;
+    ConstraintSolver     m_solver;
+    ContactCache         m_contactCache;
 
+    void pullTransforms();
+    void gatherBodies();
+    void scatterBodies();
+#if PHYSICS_ENABLE_STATS
+    void collectStats(size_t memoryBefore);
+#endif
+    void interpolateTransforms(float alpha);
+    void physicsThreadLoop();
+    void publishSnapshot();
+    void syncTransforms();
+    void applyTeleports();
+    void placeShape(int32_t proxyId, const RigidBody& body, const Collider& col);
+    void clampToHeightfield();
+    void buildModelMeshes();
+    void updateBroadphase(float fixedDeltaTime);
     void detectCollision();
+    void updateIslands(float fixedDeltaTime);
+    void updateQueryBounds();
+    void sweepBullets(float fixedDeltaTime);
+    void updateContactEvents();
+    void dispatchContactEvents();
+    void wakeIsland(RigidBody& body);
+    RigidBody* findBody(entt::entity entity);
+    Collider* findCollider(entt::entity entity);
+    void releaseProxy(Collider& col);
+    void wakeBodiesIn(const AABB& box);
+    void gatherCharacterCandidates(const AABB& box, const CharacterDesc& desc);
+    bool findCharacterContact(const ShapeInstance& capsule, const glm::vec3& direction, float maxSeparation, ContactManifold& contact) const;
+
+    // Registry hooks that release broadphase proxies
+    void connectScene();
+    void disconnectScene();
+    void onColliderDestroyed(entt::registry& reg, entt::entity entity);
+    void onRigidBodyDestroyed(entt::registry& reg, entt::entity entity);
+    void onWorldBodyDestroyed(entt::registry& reg, entt::entity entity);
+
+    // World owned bodies and colliders
+    struct BodySlot {
+        RigidBody body;
+        entt::entity entity = entt::null;
+        ColliderID collider = kInvalidHandle;
+    };
+    struct ColliderSlot {
+        Collider collider;
+        RigidBodyID body = kInvalidHandle;
+    };
+    SlotMap<BodySlot>         m_worldBodies;
+    SlotMap<ColliderSlot>     m_worldColliders;
+
+    // Every simulated body of the step, registry and world owned alike.
+    // Rebuilt at the start of each step, collider/transform may be null.
+    struct SimBody {
+        entt::entity entity;
+        RigidBody* body;
+        Collider* collider;
+        Transform* transform;
+    };
+    std::vector<SimBody>      m_simBodies;
+    ProxyTable<int32_t>       m_proxyOwners; // m_simBodies index per proxy id
+    BodyStore                 m_bodyStore;
+    TaskPool                  m_taskPool;
+
+    std::vector<std::vector<ContactManifold>> m_chunkContacts;
+    std::vector<ContactManifold> m_contacts;
+
+    // World space shapes and their tight boxes indexed by proxy id, placed
+    // before the narrowphase and refreshed after every step for queries
+    ProxyTable<ShapeInstance> m_proxyShapes;
+    ProxyTable<AABB>          m_proxyBounds;
+
+    PhysicsStats              m_stats;
+
+    std::vector<int32_t>      m_characterCandidates; // proxies near the current character move
 
-    void resolveCollision(RigidBody& bodyA, Collider& colA, Transform& transA, RigidBody& bodyB, Collider& colB, Transform& transB);
+    IslandManager             m_islands;
+    std::vector<uint32_t>     m_awakeBodies; // m_simBodies indices
+    std::vector<std::pair<int32_t, int32_t>> m_islandLinks;
+    std::vector<float>        m_islandSleepTime;
+    std::vector<int32_t>      m_rootIsland;
+    bool m_allowSleeping = true;
 
+    // Contact events, rebuilt every step from the touching pairs
+    struct TouchingPair {
+        uint64_t pairId;
+        uint32_t entityA;
+        uint32_t entityB;
+        glm::vec3 normal;
+        bool isTrigger;
+        bool asleep;
+    };
+    std::vector<ContactManifold> m_triggerContacts;
+    std::vector<TouchingPair> m_touching;
+    std::vector<TouchingPair> m_previousTouching;
+    std::vector<ContactEvent> m_contactEvents;
+    ContactEventCallback      m_contactEventCallback;
+    CollisionCallback         m_collisionCallback;
+    TriggerCallback           m_triggerCallback;
+    // Fixed step driver
+    float    m_fixedDeltaTime = 1.0f / 60.0f;
+    uint32_t m_maxSubsteps = 4;
+    float    m_accumulator = 0.0f;
+    float    m_interpolationAlpha = 0.0f;
+
+    // Physics thread
+    struct TransformSnapshot {
+        struct Entry {
+            entt::entity entity;
+            glm::vec3 previous;
+            glm::vec3 current;
+            glm::vec3 rotation;
+        };
+        std::vector<Entry> entries;
+        std::vector<glm::vec4> projectiles; // see ProjectilePool::getRenderInstances()
+        std::chrono::steady_clock::time_point stepTime;
+        uint64_t teleportSequence = 0; // last teleport included
+    };
+    struct Teleport {
+        entt::entity entity;
+        glm::vec3 position;
+        glm::vec3 rotation;
+        uint64_t sequence;
+    };
+
+    bool                              m_threaded = false;
+    std::atomic<bool>                 m_threadRunning{ false };
+    std::thread                       m_physicsThread;
+    std::mutex                        m_sceneMutex;
+    TripleBuffer<TransformSnapshot>   m_snapshots;
+
+    std::mutex                        m_teleportMutex;
+    std::vector<Teleport>             m_pendingTeleports;
+    uint64_t                          m_appliedTeleportSequence = 0; // physics thread
+
+    // Main thread side of the sync
+    uint64_t                          m_teleportSequence = 0;
+    std::unordered_map<entt::entity, glm::vec3> m_renderedPositions;
+    std::unordered_map<entt::entity, glm::vec3> m_previousRendered;
+    std::unordered_map<entt::entity, uint64_t>  m_heldEntities;
+
+    // Transform scale each model mesh was built with, see buildModelMeshes()
+    std::unordered_map<entt::entity, glm::vec3> m_modelMeshScales;
 
-    std::vector<RigidBody*>   m_rigidBodies;
-    std::vector<Collider*>    m_colliders;
     Scene* m_Scene;
+    std::shared_ptr<const Heightfield> m_heightfield;
     float gravity = -9.81f;
+    float floorHeight = -5.0f;
+};
+
+struct PhysicsWorld::Snapshot {
+    struct Body {
+        entt::entity entity;
+        RigidBody body;
+    };
+
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    std::vector<TouchingPair> touching;
+    std::vector<uint32_t> islandOffsets; // see IslandManager::saveSleepingIslands()
+    std::vector<uint32_t> islandMembers;
+    std::vector<int32_t> freeIslands;
+    std::vector<ProjectileDesc> projectiles; // see ProjectilePool::save()
+
+    // Every record is copied as raw bytes
+    static_assert(std::is_trivially_copyable_v<Body>);
+    static_assert(std::is_trivially_copyable_v<ContactManifold>);
+    static_assert(std::is_trivially_copyable_v<TouchingPair>);
+    static_assert(std::is_trivially_copyable_v<ProjectileDesc>);
+
+    size_t getMemoryUsage() const
+    {
+        return bodies.capacity() * sizeof(Body) + manifolds.capacity() * sizeof(ContactManifold)
+            + touching.capacity() * sizeof(TouchingPair)
+            + (islandOffsets.capacity() + islandMembers.capacity()) * sizeof(uint32_t)
+            + freeIslands.capacity() * sizeof(int32_t) + projectiles.capacity() * sizeof(ProjectileDesc);
+    }
 };
+
+template<typename... Component, typename Func>
+void PhysicsWorld::eachContactEvent(Func&& func)
+{
+    entt::registry& reg = m_Scene->GetRegistry();
+
+    auto visit = [&](entt::entity self, entt::entity other, const ContactEvent& event) {
+        if (self == entt::null || !reg.valid(self)) return;
+
+        if constexpr (sizeof...(Component) == 0) {
+            func(self, other, event);
+        }
+        else if (reg.all_of<Component...>(self)) {
+            func(self, other, event, reg.get<Component>(self)...);
+        }
+        };
+
+    for (const ContactEvent& event : m_contactEvents) {
+        visit(event.entityA, event.entityB, event);
+        visit(event.entityB, event.entityA, event);
+    }
+}
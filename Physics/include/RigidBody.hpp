@@ -9,6 +9,7 @@ struct RigidBodyDesc {
     float mass = 1.0f;
     bool isKinematic = false;
     bool useGravity = true;
+    bool isStatic = false; // level geometry, never moves once the world has seen it
 };
 
 class RigidBody {
@@ -18,7 +19,10 @@ public:
         velocity(desc.velocity),
         mass(desc.mass),
         isKinematic(desc.isKinematic),
-        useGravity(desc.useGravity)
+        useGravity(desc.useGravity),
+        isStatic(desc.isStatic),
+        previousPosition(desc.position),
+        syncedPosition(desc.position)
     {
     }
 
@@ -27,5 +31,23 @@ public:
     float mass;
     bool useGravity;
     bool isKinematic;
- 
+
+    // Lives in the broadphase's static tree instead of being simulated. Moving
+    // it through Transform or a teleport recreates its proxy, which is slow.
+    bool isStatic;
+
+    // Euler angles in degrees, mirrored from Transform for the collider orientation
+    glm::vec3 rotation{ 0.0f };
+
+    // Sleep state, managed by PhysicsWorld
+    bool isSleeping = false;
+    float sleepTimer = 0.0f;
+    int32_t islandId = -1;   // sleeping island this body belongs to
+    int32_t storeIndex = -1; // slot in the step's BodyStore, -1 while asleep
+
+    // Position at the start of the last fixed step, for render interpolation
+    glm::vec3 previousPosition;
+
+    // Last position written to Transform, a mismatch means something else moved the entity
+    glm::vec3 syncedPosition;
 };
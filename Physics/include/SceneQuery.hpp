@@ -0,0 +1,49 @@
+#pragma once
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+#include <AABB.hpp>
+#include <Narrowphase.hpp>
+
+class DynamicTree;
+class StaticTree;
+
+struct Ray {
+    glm::vec3 origin{ 0.0f };
+    glm::vec3 direction{ 0.0f, 0.0f, -1.0f }; // normalized
+    float maxDistance = FLT_MAX;
+};
+
+struct RaycastHit {
+    entt::entity body = entt::null; // entity of the hit rigid body
+    float distance = FLT_MAX;
+    glm::vec3 point{ 0.0f };
+    glm::vec3 normal{ 0.0f };
+
+    bool hasHit() const { return body != entt::null; }
+};
+
+// Slab test. On a hit returns the entry distance (0 when starting inside)
+// and the normal of the face that was entered.
+bool intersectRayAABB(const Ray& ray, const AABB& box, float maxDistance, float& distance, glm::vec3& normal);
+
+// Exact ray against a placed shape, bounds is only the early-out box. Spheres,
+// capsules and boxes can be grown by inflate (boxes keep square corners),
+// meshes trace their triangles with the bare ray. Starting inside reports
+// distance 0 and the reversed direction like intersectRayAABB.
+bool intersectRayShape(const Ray& ray, const ShapeInstance& shape, const AABB& bounds, float maxDistance, float& distance, glm::vec3& normal,
+    float inflate = 0.0f);
+
+// Rays traced together through the tree, one SIMD lane each
+constexpr size_t kRayPacketSize = 8;
+
+// Traces up to kRayPacketSize rays through both trees at once. A node is
+// visited if any ray of the packet can still hit it. Leaves are tested
+// against leafBounds[proxyId] or staticBounds[static index] (tight boxes),
+// then per ray against shapes[proxyId] or staticShapes[static index].
+// hits[i].body receives the entity in the leaf user data.
+void raycastPacket(const DynamicTree& tree, const std::vector<AABB>& leafBounds, const std::vector<ShapeInstance>& shapes,
+    const StaticTree& staticTree, const std::vector<AABB>& staticBounds, const std::vector<ShapeInstance>& staticShapes,
+    const Ray* rays, size_t count, RaycastHit* hits);
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <AABB.hpp>
+#include <BodyStore.hpp>
+
+// True when the CPU and OS support AVX2, checked once
+bool cpuHasAvx2();
+
+// Rays in SoA form, one lane per ray. Unused lanes have tMax < 0 and never hit.
+struct alignas(32) RayPacket {
+    float ox[kSimdWidth], oy[kSimdWidth], oz[kSimdWidth];
+    float ix[kSimdWidth], iy[kSimdWidth], iz[kSimdWidth];
+    float tMax[kSimdWidth];
+};
+
+// The AVX2 kernels are the only code built with AVX2 enabled (src/avx2/,
+// PHYSICS_ENABLE_AVX2). Callers pick them when cpuHasAvx2() and otherwise
+// keep their SSE2 or scalar path, so the library runs on any x86-64 CPU.
+// They work on raw arrays and call no inline functions, an AVX2 copy of a
+// shared inline function could otherwise be the one the linker keeps.
+#if PHYSICS_HAVE_AVX2
+namespace avx2 {
+
+// BodyStore::integrateVelocities, padded is a multiple of kSimdWidth
+void integrateVelocities(float* vy, const uint64_t* gravityBits, const uint64_t* kinematicBits, size_t padded,
+    float gravityStep);
+// BodyStore::integratePositions
+void integratePositions(float* px, float* py, float* pz, const float* vx, float* vy, const float* vz, size_t padded,
+    float dt, float floorY);
+
+// AABBBatch::overlapMask for the block at begin, without the live lane mask
+uint32_t overlapMask(const float* minX, const float* minY, const float* minZ,
+    const float* maxX, const float* maxY, const float* maxZ, size_t begin, const AABB& aabb);
+
+// Slab test of every packet lane against box, see SceneQuery.cpp
+uint32_t intersectPacket(const RayPacket& packet, const AABB& box, float* enter);
+
+} // namespace avx2
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+// Dense storage addressed through stable 32-bit handles. The low bits pick a
+// slot, the high bits hold the slot's generation, which is bumped every time
+// the slot is freed so stale handles stop resolving. Values are kept packed
+// (swap-remove), pointers into the map are only valid until the next
+// insert or erase.
+template<typename T>
+class SlotMap {
+public:
+    using Handle = uint32_t;
+
+    static constexpr uint32_t kIndexBits = 20;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+
+    template<typename... Args>
+    Handle emplace(Args&&... args)
+    {
+        uint32_t slot;
+        if (m_freeHead != kNoSlot) {
+            slot = m_freeHead;
+            m_freeHead = m_slots[slot].dense;
+        }
+        else {
+            // The last index is left out so no handle equals kInvalidHandle
+            if (m_slots.size() >= kIndexMask) return kInvalidHandle;
+            slot = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back({ 0, 0 });
+        }
+
+        m_slots[slot].dense = static_cast<uint32_t>(m_values.size());
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_handles.push_back(makeHandle(slot, m_slots[slot].generation));
+        return m_handles.back();
+    }
+
+    bool erase(Handle handle)
+    {
+        if (!contains(handle)) return false;
+
+        uint32_t slot = handle & kIndexMask;
+        uint32_t dense = m_slots[slot].dense;
+
+        // Keep values packed, the last one takes the freed place
+        if (dense != m_values.size() - 1) {
+            m_values[dense] = std::move(m_values.back());
+            m_handles[dense] = m_handles.back();
+            m_slots[m_handles[dense] & kIndexMask].dense = dense;
+        }
+        m_values.pop_back();
+        m_handles.pop_back();
+
+        m_slots[slot].generation = (m_slots[slot].generation + 1) & kGenerationMask;
+        m_slots[slot].dense = m_freeHead;
+        m_freeHead = slot;
+        return true;
+    }
+
+    bool contains(Handle handle) const
+    {
+        uint32_t slot = handle & kIndexMask;
+        return handle != kInvalidHandle && slot < m_slots.size() &&
+            m_slots[slot].generation == (handle >> kIndexBits) &&
+            m_slots[slot].dense < m_values.size() && m_handles[m_slots[slot].dense] == handle;
+    }
+
+    T* get(Handle handle) { return contains(handle) ? &m_values[m_slots[handle & kIndexMask].dense] : nullptr; }
+    const T* get(Handle handle) const { return contains(handle) ? &m_values[m_slots[handle & kIndexMask].dense] : nullptr; }
+
+    void clear()
+    {
+        // Bump every live slot so outstanding handles go stale
+        for (Handle handle : m_handles) {
+            uint32_t slot = handle & kIndexMask;
+            m_slots[slot].generation = (m_slots[slot].generation + 1) & kGenerationMask;
+            m_slots[slot].dense = m_freeHead;
+            m_freeHead = slot;
+        }
+        m_values.clear();
+        m_handles.clear();
+    }
+
+    // --- Dense access ---
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+    T& operator[](size_t denseIndex) { return m_values[denseIndex]; }
+    const T& operator[](size_t denseIndex) const { return m_values[denseIndex]; }
+    Handle getHandle(size_t denseIndex) const { return m_handles[denseIndex]; }
+
+    auto begin() { return m_values.begin(); }
+    auto end() { return m_values.end(); }
+    auto begin() const { return m_values.begin(); }
+    auto end() const { return m_values.end(); }
+
+    size_t getMemoryUsage() const
+    {
+        return m_values.capacity() * sizeof(T) + m_handles.capacity() * sizeof(Handle) + m_slots.capacity() * sizeof(Slot);
+    }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    // dense is the value index while alive and the next free slot once freed
+    struct Slot {
+        uint32_t dense;
+        uint32_t generation;
+    };
+
+    static Handle makeHandle(uint32_t slot, uint32_t generation) { return (generation << kIndexBits) | slot; }
+
+    std::vector<T> m_values;
+    std::vector<Handle> m_handles;
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead = kNoSlot;
+};
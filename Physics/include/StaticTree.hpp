@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <DynamicTree.hpp>
+
+struct StaticNode {
+    bool isLeaf() const { return proxyId != kNullNode; }
+
+    AABB aabb;
+    int32_t child1 = kNullNode;
+    int32_t child2 = kNullNode;
+    int32_t proxyId = kNullNode; // leaf proxy, kNullNode for inner nodes
+};
+
+// Bounding volume hierarchy for geometry that never moves. Proxies added or
+// removed only take effect on the next build(), which lays the whole tree out
+// again top down. Nodes are stored depth first so a traversal mostly walks
+// forward through memory, and leaves use the tight AABB since nothing moves.
+class StaticTree {
+public:
+    // --- Proxy management ---
+    int32_t createProxy(const AABB& aabb, uint32_t userData);
+    void destroyProxy(int32_t proxyId);
+
+    // Rebuilds the hierarchy from the live proxies
+    void build();
+    bool needsBuild() const { return m_dirty; }
+
+    const AABB& getAABB(int32_t proxyId) const { return m_proxies[proxyId].aabb; }
+    uint32_t getUserData(int32_t proxyId) const { return m_proxies[proxyId].userData; }
+
+    // --- Queries, same contracts as DynamicTree ---
+    template<typename Callback>
+    void query(const AABB& aabb, Callback&& callback) const;
+
+    template<typename Callback>
+    void rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback, float radius = 0.0f) const;
+
+    // Raw node access for custom traversals such as ray packets
+    int32_t getRoot() const { return m_nodes.empty() ? kNullNode : 0; }
+    const StaticNode& getNode(int32_t nodeId) const { return m_nodes[nodeId]; }
+
+    // --- Stats ---
+    int32_t getProxyCount() const { return m_proxyCount; }
+    int32_t getNodeCount() const { return static_cast<int32_t>(m_nodes.size()); }
+    size_t getMemoryUsage() const;
+
+private:
+    struct Proxy {
+        AABB aabb;
+        uint32_t userData = 0;
+        bool alive = false;
+    };
+
+    int32_t buildRange(size_t begin, size_t end);
+
+    std::vector<Proxy> m_proxies;
+    std::vector<int32_t> m_freeProxies;
+    std::vector<StaticNode> m_nodes;
+    std::vector<int32_t> m_buildOrder; // scratch for build()
+    int32_t m_proxyCount = 0;
+    bool m_dirty = false;
+};
+
+template<typename Callback>
+void StaticTree::query(const AABB& aabb, Callback&& callback) const
+{
+    if (m_nodes.empty()) return;
+
+    TreeStack stack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+        const StaticNode& node = m_nodes[stack.pop()];
+        if (!node.aabb.overlaps(aabb)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(node.proxyId)) return;
+        }
+        else {
+            stack.push(node.child2);
+            stack.push(node.child1);
+        }
+    }
+}
+
+template<typename Callback>
+void StaticTree::rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback, float radius) const
+{
+    if (m_nodes.empty()) return;
+
+    // Zero components become huge instead of infinite so 0 * inf can't produce NaN
+    glm::vec3 invDirection;
+    for (int axis = 0; axis < 3; ++axis) {
+        float d = direction[axis];
+        invDirection[axis] = 1.0f / (d != 0.0f ? d : 1e-20f);
+    }
+
+    TreeStack stack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+        const StaticNode& node = m_nodes[stack.pop()];
+        glm::vec3 t1 = (node.aabb.min - radius - origin) * invDirection;
+        glm::vec3 t2 = (node.aabb.max + radius - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t1, t2);
+        glm::vec3 tFar = glm::max(t1, t2);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        if (enter > exit) continue;
+
+        if (node.isLeaf()) {
+            maxDistance = callback(node.proxyId, maxDistance);
+            if (maxDistance <= 0.0f) return;
+        }
+        else {
+            stack.push(node.child2);
+            stack.push(node.child1);
+        }
+    }
+}
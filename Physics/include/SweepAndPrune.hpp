@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <AABB.hpp>
+
+// Sweep-and-prune over three axes. Endpoint arrays stay sorted between steps
+// and are repaired with insertion sort, so coherent scenes sort in near O(n).
+// Overlap changes are detected from endpoint swaps and reported as deltas.
+class SweepAndPrune {
+public:
+    // --- Proxy management (ids are owned by the Broadphase) ---
+    void addProxy(int32_t proxyId, const AABB& aabb);
+    void updateProxy(int32_t proxyId, const AABB& aabb);
+    void removeProxy(int32_t proxyId);
+    void clear();
+
+    // Re-sorts the endpoints and appends ordered proxy pair keys that started or stopped overlapping.
+    // Deltas may contain pairs that did not actually change, callers filter against their pair set.
+    void updatePairs(std::vector<uint64_t>& added, std::vector<uint64_t>& removed);
+
+    size_t getMemoryUsage() const;
+
+private:
+    struct Endpoint {
+        float value;
+        uint32_t data; // proxyId << 1 | isMax
+
+        int32_t proxyId() const { return static_cast<int32_t>(data >> 1); }
+        bool isMax() const { return (data & 1u) != 0; }
+    };
+
+    struct Box {
+        AABB aabb;
+        uint32_t minIndex[3];
+        uint32_t maxIndex[3];
+        bool active = false;
+    };
+
+    void sortAxis(int axis, std::vector<uint64_t>& added, std::vector<uint64_t>& removed);
+
+    std::vector<Endpoint> m_endpoints[3];
+    std::vector<Box> m_boxes; // indexed by proxy id
+    bool m_dirty = false;
+};
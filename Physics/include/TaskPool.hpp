@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel physics phases.
+// Work is split into fixed-size chunks, so chunk boundaries (and any
+// per-chunk output) depend only on the item count, never on thread count.
+class TaskPool {
+public:
+    // Called with [begin, end) and the chunk index
+    using Task = std::function<void(size_t begin, size_t end, size_t chunk)>;
+
+    // Picks hardware_concurrency - 1 workers
+    static constexpr uint32_t kHardwareWorkers = UINT32_MAX;
+
+    // The calling thread always helps, so 0 workers runs everything inline
+    explicit TaskPool(uint32_t workerCount = kHardwareWorkers);
+    ~TaskPool();
+
+    // Non-copyable, non-movable
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Blocks until every chunk has run
+    void parallelFor(size_t count, size_t chunkSize, const Task& task);
+
+    static size_t chunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+
+    // Queues a background job, such as a mesh build, for the next idle
+    // worker and returns right away. parallelFor chunks go first, a worker
+    // busy with a job just sits that parallelFor out. Without workers the
+    // job runs inline. Jobs still queued when the pool is destroyed are
+    // dropped, so they must not depend on running.
+    void submit(std::function<void()> job);
+
+    void setWorkerCount(uint32_t workerCount);
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+private:
+    void start(uint32_t workerCount);
+    void stop();
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCV;
+    std::condition_variable m_doneCV;
+    bool m_shouldExit = false;
+    uint64_t m_generation = 0;
+
+    // Current job, only valid while a parallelFor is running
+    const Task* m_task = nullptr;
+    size_t m_count = 0;
+    size_t m_chunkSize = 1;
+    size_t m_chunkCount = 0;
+    std::atomic<size_t> m_nextChunk{ 0 };
+    std::atomic<size_t> m_pendingChunks{ 0 };
+    uint32_t m_activeWorkers = 0;
+
+    std::deque<std::function<void()>> m_jobs;
+};
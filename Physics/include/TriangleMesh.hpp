@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <AABB.hpp>
+#include <DynamicTree.hpp>
+
+class TaskPool;
+class TriangleMesh;
+
+// Pending result of a mesh build on a TaskPool, colliders hold it. Copies
+// share the build. The job only keeps a weak reference, so dropping the
+// last copy cancels a build that hasn't started and never waits for one
+// that has.
+class TriangleMeshFuture {
+public:
+    bool valid() const { return m_state != nullptr; }
+    bool isReady() const { return m_state && m_state->ready.load(std::memory_order_acquire); }
+    // nullptr until the build has finished
+    const TriangleMesh* get() const { return isReady() ? m_state->mesh.get() : nullptr; }
+    // Blocks until the build has finished, for tools and tests
+    void wait() const;
+
+private:
+    friend class TriangleMesh;
+
+    struct State {
+        std::shared_ptr<const TriangleMesh> mesh;
+        std::atomic<bool> ready{ false };
+    };
+    std::shared_ptr<State> m_state;
+};
+
+// Static triangle soup with its own bounding volume hierarchy, in the local
+// frame of the collider. Node boxes are quantized to 16 bits per axis inside
+// the mesh bounds, always rounded outwards, so a node takes 16 bytes. Nodes
+// are stored depth first with the left child right after its parent, and
+// triangles are reordered so every leaf owns a contiguous range.
+class TriangleMesh {
+public:
+    // Three indices per triangle. Degenerate triangles and out of range
+    // indices are dropped.
+    TriangleMesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+
+    // Builds the mesh on a worker of pool
+    static TriangleMeshFuture buildAsync(TaskPool& pool, std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+    // Runs build on a worker of pool, for meshes whose triangles are gathered there too
+    static TriangleMeshFuture buildAsync(TaskPool& pool, std::function<std::shared_ptr<const TriangleMesh>()> build);
+
+    const AABB& getBounds() const { return m_bounds; }
+    uint32_t getTriangleCount() const { return static_cast<uint32_t>(m_indices.size() / 3); }
+    void getTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const {
+        a = m_vertices[m_indices[3 * triangle]];
+        b = m_vertices[m_indices[3 * triangle + 1]];
+        c = m_vertices[m_indices[3 * triangle + 2]];
+    }
+
+    // Calls callback(triangle) for every triangle whose leaf overlaps aabb,
+    // stops when it returns false
+    template<typename Callback>
+    void query(const AABB& aabb, Callback&& callback) const;
+
+    // Same, with leaves culled against the sphere instead of its box
+    template<typename Callback>
+    void querySphere(const glm::vec3& center, float radius, Callback&& callback) const;
+
+    // Closest triangle along the ray, either side counts. The normal faces
+    // against the ray.
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance, glm::vec3& normal) const;
+
+    int32_t getNodeCount() const { return static_cast<int32_t>(m_nodes.size()); }
+    size_t getMemoryUsage() const;
+
+private:
+    static constexpr uint32_t kLeafBit = 0x80000000u;
+    static constexpr uint32_t kLeafCountBits = 3;
+    static constexpr uint32_t kMaxLeafTriangles = 4;
+
+    struct Node {
+        bool isLeaf() const { return (data & kLeafBit) != 0; }
+        uint32_t getFirstTriangle() const { return (data & ~kLeafBit) >> kLeafCountBits; }
+        uint32_t getTriangleCount() const { return data & ((1u << kLeafCountBits) - 1); }
+
+        uint16_t min[3];
+        uint16_t max[3];
+        uint32_t data; // leaf: first triangle and count, inner: index of the second child
+    };
+    static_assert(sizeof(Node) == 16, "TriangleMesh nodes are meant to stay 16 bytes");
+
+    struct QuantizedBox {
+        uint16_t min[3];
+        uint16_t max[3];
+    };
+
+    QuantizedBox quantize(const AABB& aabb) const;
+    AABB dequantize(const Node& node) const;
+    static bool overlaps(const Node& node, const QuantizedBox& box);
+
+    uint32_t buildRange(std::vector<uint32_t>& order, const std::vector<AABB>& bounds, size_t begin, size_t end);
+
+    std::vector<glm::vec3> m_vertices;
+    std::vector<uint32_t> m_indices; // in leaf order
+    std::vector<Node> m_nodes;
+    AABB m_bounds;
+    glm::vec3 m_quantScale{ 0.0f };
+    glm::vec3 m_quantInvScale{ 0.0f };
+};
+
+inline bool TriangleMesh::overlaps(const Node& node, const QuantizedBox& box)
+{
+    return node.min[0] <= box.max[0] && node.max[0] >= box.min[0] &&
+        node.min[1] <= box.max[1] && node.max[1] >= box.min[1] &&
+        node.min[2] <= box.max[2] && node.max[2] >= box.min[2];
+}
+
+template<typename Callback>
+void TriangleMesh::query(const AABB& aabb, Callback&& callback) const
+{
+    if (m_nodes.empty() || !m_bounds.overlaps(aabb)) return;
+    QuantizedBox box = quantize(aabb);
+
+    TreeStack stack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+        uint32_t nodeId = static_cast<uint32_t>(stack.pop());
+        const Node& node = m_nodes[nodeId];
+        if (!overlaps(node, box)) continue;
+
+        if (node.isLeaf()) {
+            uint32_t first = node.getFirstTriangle();
+            for (uint32_t i = 0; i < node.getTriangleCount(); ++i) {
+                if (!callback(first + i)) return;
+            }
+        }
+        else {
+            stack.push(static_cast<int32_t>(node.data));
+            stack.push(static_cast<int32_t>(nodeId + 1));
+        }
+    }
+}
+
+template<typename Callback>
+void TriangleMesh::querySphere(const glm::vec3& center, float radius, Callback&& callback) const
+{
+    AABB sphereBox = AABB::fromCenterExtents(center, glm::vec3(radius));
+    if (m_nodes.empty() || !m_bounds.overlaps(sphereBox)) return;
+    QuantizedBox box = quantize(sphereBox);
+
+    TreeStack stack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+        uint32_t nodeId = static_cast<uint32_t>(stack.pop());
+        const Node& node = m_nodes[nodeId];
+        if (!overlaps(node, box)) continue;
+
+        if (node.isLeaf()) {
+            // Corners of the box around the sphere miss most leaves the box touches
+            AABB leaf = dequantize(node);
+            glm::vec3 d = center - glm::clamp(center, leaf.min, leaf.max);
+            if (glm::dot(d, d) > radius * radius) continue;
+
+            uint32_t first = node.getFirstTriangle();
+            for (uint32_t i = 0; i < node.getTriangleCount(); ++i) {
+                if (!callback(first + i)) return;
+            }
+        }
+        else {
+            stack.push(static_cast<int32_t>(node.data));
+            stack.push(static_cast<int32_t>(nodeId + 1));
+        }
+    }
+}
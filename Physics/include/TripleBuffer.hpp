@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Single producer, single consumer triple buffer. The writer always has a
+// buffer to fill and the reader always has a complete one, neither blocks.
+template<typename T>
+class TripleBuffer {
+public:
+    // --- Writer ---
+    T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+    // Hands the write buffer over and takes back the spare one
+    void publish() {
+        m_writeIndex = m_shared.exchange(m_writeIndex | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // --- Reader ---
+    // Picks up the latest published buffer, returns false if nothing new
+    bool acquire() {
+        if (!(m_shared.load(std::memory_order_relaxed) & kFreshBit)) return false;
+        m_readIndex = m_shared.exchange(m_readIndex, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return m_buffers[m_readIndex]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFreshBit = 0x4;
+
+    T m_buffers[3];
+    uint8_t m_writeIndex = 0;
+    uint8_t m_readIndex = 1;
+    std::atomic<uint8_t> m_shared{ 2 };
+};
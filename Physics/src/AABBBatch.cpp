@@ -0,0 +1,118 @@
+#include "AABBBatch.hpp"
+#include "SimdKernels.hpp"
+#include <cfloat>
+
+// Baseline SIMD for this file, AVX2 is chosen at runtime (SimdKernels.hpp)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_SIMD_SSE2 1
+#endif
+
+namespace {
+
+// Drops the padding lanes of the last block. Their inverted box only fails
+// against finite queries, an infinite one would still reach it.
+uint32_t liveLanes(size_t count, size_t begin)
+{
+    size_t live = count - begin;
+    return live >= kSimdWidth ? (1u << kSimdWidth) - 1 : (1u << live) - 1;
+}
+
+} // namespace
+
+void AABBBatch::clear()
+{
+    m_count = 0;
+    for (AlignedFloats* array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+        array->clear();
+    }
+}
+
+size_t AABBBatch::add(const AABB& aabb)
+{
+    if (m_count % kSimdWidth == 0) {
+        size_t padded = m_count + kSimdWidth;
+        for (AlignedFloats* array : { &minX, &minY, &minZ }) {
+            array->resize(padded, FLT_MAX);
+        }
+        for (AlignedFloats* array : { &maxX, &maxY, &maxZ }) {
+            array->resize(padded, -FLT_MAX);
+        }
+    }
+
+    size_t index = m_count++;
+    set(index, aabb);
+    return index;
+}
+
+void AABBBatch::set(size_t index, const AABB& aabb)
+{
+    minX[index] = aabb.min.x;
+    minY[index] = aabb.min.y;
+    minZ[index] = aabb.min.z;
+    maxX[index] = aabb.max.x;
+    maxY[index] = aabb.max.y;
+    maxZ[index] = aabb.max.z;
+}
+
+void AABBBatch::removeSwap(size_t index)
+{
+    size_t last = --m_count;
+    if (index != last) {
+        set(index, get(last));
+    }
+    set(last, AABB(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)));
+}
+
+AABB AABBBatch::get(size_t index) const
+{
+    return AABB({ minX[index], minY[index], minZ[index] }, { maxX[index], maxY[index], maxZ[index] });
+}
+
+uint32_t AABBBatch::overlapMask(const AABB& aabb, size_t begin) const
+{
+#if PHYSICS_HAVE_AVX2
+    if (cpuHasAvx2()) {
+        return avx2::overlapMask(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), begin, aabb) &
+            liveLanes(m_count, begin);
+    }
+#endif
+#if defined(PHYSICS_SIMD_SSE2)
+    // Overlap is !(max < other.min || min > other.max) on every axis
+    const __m128 queryMinX = _mm_set1_ps(aabb.min.x);
+    const __m128 queryMinY = _mm_set1_ps(aabb.min.y);
+    const __m128 queryMinZ = _mm_set1_ps(aabb.min.z);
+    const __m128 queryMaxX = _mm_set1_ps(aabb.max.x);
+    const __m128 queryMaxY = _mm_set1_ps(aabb.max.y);
+    const __m128 queryMaxZ = _mm_set1_ps(aabb.max.z);
+
+    // The block as two halves of four
+    uint32_t mask = 0;
+    for (size_t half = 0; half < kSimdWidth; half += 4) {
+        size_t j = begin + half;
+        __m128 hit = _mm_and_ps(_mm_cmpge_ps(_mm_load_ps(&maxX[j]), queryMinX), _mm_cmple_ps(_mm_load_ps(&minX[j]), queryMaxX));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_load_ps(&maxY[j]), queryMinY));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_load_ps(&minY[j]), queryMaxY));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_load_ps(&maxZ[j]), queryMinZ));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_load_ps(&minZ[j]), queryMaxZ));
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << half;
+    }
+    return mask & liveLanes(m_count, begin);
+#else
+    return overlapMaskScalar(aabb, begin);
+#endif
+}
+
+uint32_t AABBBatch::overlapMaskScalar(const AABB& aabb, size_t begin) const
+{
+    // Bitwise ands so compilers keep the block free of branches
+    uint32_t mask = 0;
+    for (size_t lane = 0; lane < kSimdWidth; ++lane) {
+        size_t i = begin + lane;
+        uint32_t hit = static_cast<uint32_t>(maxX[i] >= aabb.min.x) & static_cast<uint32_t>(minX[i] <= aabb.max.x) &
+            static_cast<uint32_t>(maxY[i] >= aabb.min.y) & static_cast<uint32_t>(minY[i] <= aabb.max.y) &
+            static_cast<uint32_t>(maxZ[i] >= aabb.min.z) & static_cast<uint32_t>(minZ[i] <= aabb.max.z);
+        mask |= hit << lane;
+    }
+    return mask & liveLanes(m_count, begin);
+}
@@ -0,0 +1,192 @@
+#include "BodyStore.hpp"
+#include "SimdKernels.hpp"
+
+// Baseline SIMD for this file, AVX2 is chosen at runtime (SimdKernels.hpp)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_SIMD_SSE2 1
+#endif
+
+void BodyStore::clear()
+{
+    m_count = 0;
+    for (AlignedFloats* array : { &px, &py, &pz, &vx, &vy, &vz, &invMass }) {
+        array->clear();
+    }
+    m_kinematicBits.clear();
+    m_gravityBits.clear();
+}
+
+void BodyStore::reserve(size_t count)
+{
+    size_t padded = (count + kSimdWidth - 1) / kSimdWidth * kSimdWidth;
+    for (AlignedFloats* array : { &px, &py, &pz, &vx, &vy, &vz, &invMass }) {
+        array->reserve(padded);
+    }
+    m_kinematicBits.reserve((padded + 63) / 64);
+    m_gravityBits.reserve((padded + 63) / 64);
+}
+
+size_t BodyStore::add(const glm::vec3& position, const glm::vec3& velocity, float mass, bool isKinematic, bool useGravity)
+{
+    // Grow a whole SIMD block at a time, padding lanes stay zeroed and gravity free
+    if (m_count % kSimdWidth == 0) {
+        size_t padded = m_count + kSimdWidth;
+        for (AlignedFloats* array : { &px, &py, &pz, &vx, &vy, &vz, &invMass }) {
+            array->resize(padded, 0.0f);
+        }
+        m_kinematicBits.resize((padded + 63) / 64, 0);
+        m_gravityBits.resize((padded + 63) / 64, 0);
+    }
+
+    size_t index = m_count++;
+    px[index] = position.x;
+    py[index] = position.y;
+    pz[index] = position.z;
+    vx[index] = velocity.x;
+    vy[index] = velocity.y;
+    vz[index] = velocity.z;
+    invMass[index] = (isKinematic || mass <= 0.0f) ? 0.0f : 1.0f / mass;
+    setBit(m_kinematicBits, index, isKinematic);
+    setBit(m_gravityBits, index, useGravity);
+    return index;
+}
+
+void BodyStore::integrateVelocities(float dt, float gravity)
+{
+#if PHYSICS_HAVE_AVX2
+    if (cpuHasAvx2()) {
+        avx2::integrateVelocities(vy.data(), m_gravityBits.data(), m_kinematicBits.data(), px.size(), gravity * dt);
+        return;
+    }
+#endif
+#if defined(PHYSICS_SIMD_SSE2)
+    integrateVelocitiesSimd(dt, gravity);
+#else
+    integrateVelocitiesScalar(dt, gravity);
+#endif
+}
+
+void BodyStore::integratePositions(float dt, float floorY)
+{
+#if PHYSICS_HAVE_AVX2
+    if (cpuHasAvx2()) {
+        avx2::integratePositions(px.data(), py.data(), pz.data(), vx.data(), vy.data(), vz.data(), px.size(), dt, floorY);
+        return;
+    }
+#endif
+#if defined(PHYSICS_SIMD_SSE2)
+    integratePositionsSimd(dt, floorY);
+#else
+    integratePositionsScalar(dt, floorY);
+#endif
+}
+
+void BodyStore::integrate(float dt, float gravity, float floorY)
+{
+    integrateVelocities(dt, gravity);
+    integratePositions(dt, floorY);
+}
+
+// The scalar versions mirror the SIMD kernels operation for operation so results match bit for bit
+
+void BodyStore::integrateVelocitiesScalar(float dt, float gravity)
+{
+    const float gravityStep = gravity * dt;
+    const size_t padded = px.size();
+
+    for (size_t i = 0; i < padded; ++i) {
+        bool applyGravity = testBit(m_gravityBits, i) && !testBit(m_kinematicBits, i);
+        vy[i] = vy[i] + (applyGravity ? gravityStep : 0.0f);
+    }
+}
+
+void BodyStore::integratePositionsScalar(float dt, float floorY)
+{
+    const size_t padded = px.size();
+
+    for (size_t i = 0; i < padded; ++i) {
+        px[i] = px[i] + vx[i] * dt;
+        py[i] = py[i] + vy[i] * dt;
+        pz[i] = pz[i] + vz[i] * dt;
+
+        // Clamp Y so object doesn't fall below the floor
+        bool below = py[i] < floorY;
+        py[i] = below ? floorY : py[i];
+        vy[i] = (below && vy[i] < 0.0f) ? 0.0f : vy[i];
+    }
+}
+
+void BodyStore::integrateScalar(float dt, float gravity, float floorY)
+{
+    integrateVelocitiesScalar(dt, gravity);
+    integratePositionsScalar(dt, floorY);
+}
+
+#if defined(PHYSICS_SIMD_SSE2)
+
+void BodyStore::integrateVelocitiesSimd(float dt, float gravity)
+{
+    const __m128 gravityStep = _mm_set1_ps(gravity * dt);
+    const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+    const size_t padded = px.size();
+
+    // 8 bodies per iteration as two 4-wide halves
+    for (size_t i = 0; i < padded; i += 8) {
+        uint32_t mask = gravityMask(i);
+
+        for (size_t half = 0; half < 2; ++half) {
+            size_t j = i + half * 4;
+            int halfBits = static_cast<int>((mask >> (half * 4)) & 0xFu);
+            __m128i bits = _mm_and_si128(_mm_set1_epi32(halfBits), laneBits);
+            __m128 gravityLanes = _mm_castsi128_ps(_mm_cmpeq_epi32(bits, laneBits));
+
+            __m128 vely = _mm_add_ps(_mm_load_ps(&vy[j]), _mm_and_ps(gravityLanes, gravityStep));
+            _mm_store_ps(&vy[j], vely);
+        }
+    }
+}
+
+void BodyStore::integratePositionsSimd(float dt, float floorY)
+{
+    const __m128 dtv = _mm_set1_ps(dt);
+    const __m128 floorv = _mm_set1_ps(floorY);
+    const __m128 zero = _mm_setzero_ps();
+    const size_t padded = px.size();
+
+    auto select = [](__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+        };
+
+    for (size_t j = 0; j < padded; j += 4) {
+        __m128 velx = _mm_load_ps(&vx[j]);
+        __m128 vely = _mm_load_ps(&vy[j]);
+        __m128 velz = _mm_load_ps(&vz[j]);
+
+        __m128 posx = _mm_add_ps(_mm_load_ps(&px[j]), _mm_mul_ps(velx, dtv));
+        __m128 posy = _mm_add_ps(_mm_load_ps(&py[j]), _mm_mul_ps(vely, dtv));
+        __m128 posz = _mm_add_ps(_mm_load_ps(&pz[j]), _mm_mul_ps(velz, dtv));
+
+        __m128 below = _mm_cmplt_ps(posy, floorv);
+        posy = select(posy, floorv, below);
+        __m128 falling = _mm_and_ps(below, _mm_cmplt_ps(vely, zero));
+        vely = select(vely, zero, falling);
+
+        _mm_store_ps(&px[j], posx);
+        _mm_store_ps(&py[j], posy);
+        _mm_store_ps(&pz[j], posz);
+        _mm_store_ps(&vy[j], vely);
+    }
+}
+
+#endif
+
+size_t BodyStore::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const AlignedFloats* array : { &px, &py, &pz, &vx, &vy, &vz, &invMass }) {
+        bytes += array->capacity() * sizeof(float);
+    }
+    bytes += (m_kinematicBits.capacity() + m_gravityBits.capacity()) * sizeof(uint64_t);
+    return bytes;
+}
@@ -0,0 +1,376 @@
+#include "Broadphase.hpp"
+#include <TaskPool.hpp>
+#include <algorithm>
+#include <iterator>
+
+void Broadphase::setType(BroadphaseType type)
+{
+    if (type == m_type) return;
+    m_type = type;
+
+    // Rebuild pairs from scratch with the new backend
+    m_sap.clear();
+    m_grid.clear();
+    m_pairs.clear();
+    for (auto& pairs : m_proxyPairs.dynamicEntries) {
+        pairs.clear();
+    }
+    for (auto& pairs : m_proxyPairs.staticEntries) {
+        pairs.clear();
+    }
+    m_droppedPairs.clear();
+    m_moveBuffer.clear();
+    m_filterBuffer.clear();
+    m_tree.forEachProxy([&](int32_t proxyId) {
+        if (m_type == BroadphaseType::SweepAndPrune) {
+            m_sap.addProxy(proxyId, m_tree.getFatAABB(proxyId));
+        }
+        else if (m_type == BroadphaseType::HierarchicalGrid) {
+            m_grid.addProxy(proxyId, m_tree.getFatAABB(proxyId));
+        }
+        bufferMove(proxyId);
+        });
+
+    // Static pairs come back through the moved proxies
+    m_createdStatic.clear();
+}
+
+int32_t Broadphase::createProxy(const AABB& aabb, uint32_t userData, uint32_t layer, uint32_t mask)
+{
+    int32_t proxyId = m_tree.createProxy(aabb, userData);
+    if (static_cast<size_t>(proxyId) >= m_filters.size()) {
+        m_filters.resize(proxyId + 1);
+    }
+    m_filters[proxyId] = { layer, mask };
+    m_proxyPairs.reserveEntry(proxyId);
+
+    if (m_type == BroadphaseType::SweepAndPrune) {
+        m_sap.addProxy(proxyId, m_tree.getFatAABB(proxyId));
+    }
+    else if (m_type == BroadphaseType::HierarchicalGrid) {
+        m_grid.addProxy(proxyId, m_tree.getFatAABB(proxyId));
+    }
+    bufferMove(proxyId);
+    return proxyId;
+}
+
+int32_t Broadphase::createStaticProxy(const AABB& aabb, uint32_t userData, uint32_t layer, uint32_t mask)
+{
+    int32_t index = m_staticTree.createProxy(aabb, userData);
+    if (static_cast<size_t>(index) >= m_staticFilters.size()) {
+        m_staticFilters.resize(index + 1);
+    }
+    m_staticFilters[index] = { layer, mask };
+
+    int32_t proxyId = index | kStaticProxyBit;
+    m_proxyPairs.reserveEntry(proxyId);
+    m_createdStatic.push_back(proxyId);
+    return proxyId;
+}
+
+void Broadphase::destroyProxy(int32_t proxyId)
+{
+    // Drop anything referencing the proxy now, its node may be reused before the next update
+    m_createdStatic.erase(std::remove(m_createdStatic.begin(), m_createdStatic.end(), proxyId), m_createdStatic.end());
+    m_moveBuffer.erase(std::remove(m_moveBuffer.begin(), m_moveBuffer.end(), proxyId), m_moveBuffer.end());
+    m_filterBuffer.erase(std::remove(m_filterBuffer.begin(), m_filterBuffer.end(), proxyId), m_filterBuffer.end());
+    dropProxyPairs(proxyId);
+
+    if (isStaticProxy(proxyId)) {
+        m_staticTree.destroyProxy(getStaticIndex(proxyId));
+        return;
+    }
+
+    if (m_type == BroadphaseType::SweepAndPrune) {
+        m_sap.removeProxy(proxyId);
+    }
+    else if (m_type == BroadphaseType::HierarchicalGrid) {
+        m_grid.removeProxy(proxyId);
+    }
+    m_tree.destroyProxy(proxyId);
+}
+
+void Broadphase::moveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement)
+{
+    if (m_tree.moveProxy(proxyId, aabb, displacement)) {
+        if (m_type == BroadphaseType::SweepAndPrune) {
+            m_sap.updateProxy(proxyId, m_tree.getFatAABB(proxyId));
+        }
+        else if (m_type == BroadphaseType::HierarchicalGrid) {
+            m_grid.updateProxy(proxyId, m_tree.getFatAABB(proxyId));
+        }
+        bufferMove(proxyId);
+    }
+}
+
+void Broadphase::setProxyFilter(int32_t proxyId, uint32_t layer, uint32_t mask)
+{
+    ProxyFilter& filter = getFilter(proxyId);
+    if (filter.layer == layer && filter.mask == mask) return;
+    filter = { layer, mask };
+
+    // Forget the old pairs, the next update finds the ones still allowed
+    dropProxyPairs(proxyId);
+    m_filterBuffer.push_back(proxyId);
+}
+
+void Broadphase::linkPair(uint64_t pairId)
+{
+    m_proxyPairs[static_cast<int32_t>(pairFirst(pairId))].push_back(pairId);
+    m_proxyPairs[static_cast<int32_t>(pairSecond(pairId))].push_back(pairId);
+}
+
+void Broadphase::unlinkPair(int32_t proxyId, uint64_t pairId)
+{
+    // Lists hold a handful of pairs, order doesn't matter
+    std::vector<uint64_t>& pairs = m_proxyPairs[proxyId];
+    auto it = std::find(pairs.begin(), pairs.end(), pairId);
+    if (it != pairs.end()) {
+        *it = pairs.back();
+        pairs.pop_back();
+    }
+}
+
+void Broadphase::dropProxyPairs(int32_t proxyId)
+{
+    std::vector<uint64_t>& pairs = m_proxyPairs[proxyId];
+    for (uint64_t pairId : pairs) {
+        uint32_t first = pairFirst(pairId);
+        int32_t other = static_cast<int32_t>(first == static_cast<uint32_t>(proxyId) ? pairSecond(pairId) : first);
+        unlinkPair(other, pairId);
+        m_droppedPairs.push_back(pairId);
+    }
+    pairs.clear();
+}
+
+void Broadphase::bufferMove(int32_t proxyId)
+{
+    m_moveBuffer.push_back(proxyId);
+}
+
+constexpr size_t kQueryChunkSize = 64;
+
+void Broadphase::updatePairs(TaskPool* pool)
+{
+    m_addedPairs.clear();
+    m_removedPairs.clear();
+
+    bool staticChanged = m_staticTree.needsBuild();
+    if (m_moveBuffer.empty() && m_filterBuffer.empty() && m_droppedPairs.empty() && !staticChanged) return;
+
+    // Static geometry only changes at load or by explicit recreation
+    if (staticChanged) {
+        m_staticTree.build();
+    }
+
+    if (m_type == BroadphaseType::SweepAndPrune) {
+        // Swaps report every new overlap, drop the ones the filters reject
+        m_sap.updatePairs(m_addedPairs, m_removedPairs);
+        m_addedPairs.erase(std::remove_if(m_addedPairs.begin(), m_addedPairs.end(), [this](uint64_t pairId) {
+            return !passesFilter(static_cast<int32_t>(pairFirst(pairId)), static_cast<int32_t>(pairSecond(pairId)));
+            }), m_addedPairs.end());
+
+        for (int32_t queryProxy : m_moveBuffer) {
+            queryStaticPairs(queryProxy, m_addedPairs);
+        }
+    }
+    else if (!m_moveBuffer.empty()) {
+        // A new grid layout moves proxies between cells, but pairs stay the same
+        if (m_type == BroadphaseType::HierarchicalGrid) {
+            m_grid.updateLevels();
+        }
+        queryMovedPairs(pool);
+    }
+    queryCreatedStatic();
+    requeryFiltered();
+    removeSeparatedPairs();
+
+    for (int32_t proxyId : m_moveBuffer) {
+        m_tree.clearMoved(proxyId);
+    }
+    m_moveBuffer.clear();
+
+    applyPairDeltas();
+}
+
+void Broadphase::queryStaticPairs(int32_t queryProxy, std::vector<uint64_t>& output) const
+{
+    m_staticTree.query(m_tree.getFatAABB(queryProxy), [&](int32_t index) {
+        int32_t proxyId = index | kStaticProxyBit;
+        if (passesFilter(queryProxy, proxyId)) {
+            output.push_back(makePairId(static_cast<uint32_t>(queryProxy), static_cast<uint32_t>(proxyId)));
+        }
+        return true;
+        });
+}
+
+void Broadphase::queryCreatedStatic()
+{
+    // New static geometry has to find the dynamic proxies already resting in it
+    for (int32_t staticProxy : m_createdStatic) {
+        m_tree.query(getFatAABB(staticProxy), [&](int32_t proxyId) {
+            if (passesFilter(staticProxy, proxyId)) {
+                m_addedPairs.push_back(makePairId(static_cast<uint32_t>(proxyId), static_cast<uint32_t>(staticProxy)));
+            }
+            return true;
+            });
+    }
+    m_createdStatic.clear();
+}
+
+void Broadphase::requeryFiltered()
+{
+    // Neither backend reports pairs that already overlapped, look them up directly
+    for (int32_t queryProxy : m_filterBuffer) {
+        m_tree.query(getFatAABB(queryProxy), [&](int32_t proxyId) {
+            if (proxyId != queryProxy && passesFilter(queryProxy, proxyId)) {
+                m_addedPairs.push_back(makePairId(static_cast<uint32_t>(queryProxy), static_cast<uint32_t>(proxyId)));
+            }
+            return true;
+            });
+
+        if (!isStaticProxy(queryProxy)) {
+            queryStaticPairs(queryProxy, m_addedPairs);
+        }
+    }
+    m_filterBuffer.clear();
+}
+
+void Broadphase::removeSeparatedPairs()
+{
+    // Only pairs touching a moved proxy may have separated. SAP reports its
+    // own removals, so there only the pairs against static proxies are left.
+    // A pair of two moved proxies is visited twice, applyPairDeltas() dedups.
+    bool staticOnly = m_type == BroadphaseType::SweepAndPrune;
+    for (int32_t movedProxy : m_moveBuffer) {
+        for (uint64_t pairId : m_proxyPairs[movedProxy]) {
+            int32_t proxyA = static_cast<int32_t>(pairFirst(pairId));
+            int32_t proxyB = static_cast<int32_t>(pairSecond(pairId));
+            if (staticOnly && !isStaticProxy(proxyB)) continue;
+
+            if (!getFatAABB(proxyA).overlaps(getFatAABB(proxyB))) {
+                m_removedPairs.push_back(pairId);
+            }
+        }
+    }
+}
+
+void Broadphase::queryMovedPairs(TaskPool* pool)
+{
+    // Query the tree or grid only for proxies that were reinserted
+    auto queryRange = [this](size_t begin, size_t end, std::vector<uint64_t>& output) {
+        for (size_t i = begin; i < end; ++i) {
+            int32_t queryProxy = m_moveBuffer[i];
+            const AABB& fatAABB = m_tree.getFatAABB(queryProxy);
+
+            auto report = [&](int32_t proxyId) {
+                if (proxyId == queryProxy || !passesFilter(queryProxy, proxyId)) return true;
+
+                // Both moved: the lower id reports the pair
+                if (m_tree.wasMoved(proxyId) && proxyId < queryProxy) return true;
+
+                output.push_back(makePairId(static_cast<uint32_t>(queryProxy), static_cast<uint32_t>(proxyId)));
+                return true;
+                };
+
+            if (m_type == BroadphaseType::HierarchicalGrid) {
+                m_grid.query(fatAABB, report);
+            }
+            else {
+                m_tree.query(fatAABB, report);
+            }
+
+            queryStaticPairs(queryProxy, output);
+        }
+        };
+
+    if (pool) {
+        // The tree is read-only here, each chunk fills its own buffer
+        size_t chunks = TaskPool::chunkCount(m_moveBuffer.size(), kQueryChunkSize);
+        if (m_chunkPairs.size() < chunks) {
+            m_chunkPairs.resize(chunks);
+        }
+
+        pool->parallelFor(m_moveBuffer.size(), kQueryChunkSize, [&](size_t begin, size_t end, size_t chunk) {
+            m_chunkPairs[chunk].clear();
+            queryRange(begin, end, m_chunkPairs[chunk]);
+            });
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            m_addedPairs.insert(m_addedPairs.end(), m_chunkPairs[chunk].begin(), m_chunkPairs[chunk].end());
+        }
+    }
+    else {
+        queryRange(0, m_moveBuffer.size(), m_addedPairs);
+    }
+}
+
+void Broadphase::applyPairDeltas()
+{
+    // Dropped pairs leave first, a reused proxy id may have found them again
+    if (!m_droppedPairs.empty()) {
+        std::sort(m_droppedPairs.begin(), m_droppedPairs.end());
+        m_mergeBuffer.clear();
+        std::set_difference(m_pairs.begin(), m_pairs.end(), m_droppedPairs.begin(), m_droppedPairs.end(),
+            std::back_inserter(m_mergeBuffer));
+        m_pairs.swap(m_mergeBuffer);
+        m_droppedPairs.clear();
+    }
+
+    std::sort(m_addedPairs.begin(), m_addedPairs.end());
+    m_addedPairs.erase(std::unique(m_addedPairs.begin(), m_addedPairs.end()), m_addedPairs.end());
+    std::sort(m_removedPairs.begin(), m_removedPairs.end());
+    m_removedPairs.erase(std::unique(m_removedPairs.begin(), m_removedPairs.end()), m_removedPairs.end());
+
+    // Keep only real changes so the deltas can drive events
+    m_mergeBuffer.clear();
+    std::set_difference(m_addedPairs.begin(), m_addedPairs.end(), m_pairs.begin(), m_pairs.end(),
+        std::back_inserter(m_mergeBuffer));
+    m_addedPairs.swap(m_mergeBuffer);
+
+    m_mergeBuffer.clear();
+    std::set_intersection(m_removedPairs.begin(), m_removedPairs.end(), m_pairs.begin(), m_pairs.end(),
+        std::back_inserter(m_mergeBuffer));
+    m_removedPairs.swap(m_mergeBuffer);
+    if (m_addedPairs.empty() && m_removedPairs.empty()) return;
+
+    for (uint64_t pairId : m_removedPairs) {
+        unlinkPair(static_cast<int32_t>(pairFirst(pairId)), pairId);
+        unlinkPair(static_cast<int32_t>(pairSecond(pairId)), pairId);
+    }
+    for (uint64_t pairId : m_addedPairs) {
+        linkPair(pairId);
+    }
+
+    // Apply both deltas to the sorted persistent set
+    m_mergeBuffer.clear();
+    m_mergeBuffer.reserve(m_pairs.size() + m_addedPairs.size());
+    std::set_difference(m_pairs.begin(), m_pairs.end(), m_removedPairs.begin(), m_removedPairs.end(),
+        std::back_inserter(m_mergeBuffer));
+    m_pairs.swap(m_mergeBuffer);
+
+    m_mergeBuffer.clear();
+    std::set_union(m_pairs.begin(), m_pairs.end(), m_addedPairs.begin(), m_addedPairs.end(),
+        std::back_inserter(m_mergeBuffer));
+    m_pairs.swap(m_mergeBuffer);
+}
+
+size_t Broadphase::getMemoryUsage() const
+{
+    size_t bytes = m_tree.getMemoryUsage() + m_sap.getMemoryUsage() + m_grid.getMemoryUsage() + m_staticTree.getMemoryUsage();
+    bytes += (m_moveBuffer.capacity() + m_filterBuffer.capacity() + m_createdStatic.capacity()) * sizeof(int32_t);
+    bytes += (m_filters.capacity() + m_staticFilters.capacity()) * sizeof(ProxyFilter);
+    bytes += (m_pairs.capacity() + m_addedPairs.capacity() + m_removedPairs.capacity() + m_mergeBuffer.capacity() +
+        m_droppedPairs.capacity()) * sizeof(uint64_t);
+    bytes += m_proxyPairs.getMemoryUsage();
+    for (const auto& pairs : m_proxyPairs.dynamicEntries) {
+        bytes += pairs.capacity() * sizeof(uint64_t);
+    }
+    for (const auto& pairs : m_proxyPairs.staticEntries) {
+        bytes += pairs.capacity() * sizeof(uint64_t);
+    }
+    for (const auto& chunk : m_chunkPairs) {
+        bytes += chunk.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,289 @@
+#include "ConstraintSolver.hpp"
+#include "BodyStore.hpp"
+#include "TaskPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Penetration allowed before position correction kicks in
+constexpr float kLinearSlop = 0.005f;
+// Fraction of the remaining penetration removed per step
+constexpr float kBaumgarte = 0.2f;
+
+// Manifolds per prepare task
+constexpr size_t kPrepareChunkSize = 256;
+// Small islands per solve task
+constexpr size_t kIslandChunkSize = 4;
+// Contacts per task inside one colour
+constexpr size_t kColorChunkSize = 64;
+// Islands with at least this many contacts are graph coloured
+constexpr uint32_t kLargeIslandContacts = 128;
+// One bit per colour in the body masks, the rest goes to a serial batch
+constexpr uint32_t kMaxColors = 64;
+
+namespace {
+
+glm::vec3 loadVelocity(const BodyStore& bodies, int32_t index)
+{
+    return index < 0 ? glm::vec3(0.0f) : bodies.getVelocity(index);
+}
+
+void applyImpulse(BodyStore& bodies, int32_t index, const glm::vec3& impulse)
+{
+    if (index < 0) return;
+
+    float invMass = bodies.invMass[index];
+    bodies.vx[index] += impulse.x * invMass;
+    bodies.vy[index] += impulse.y * invMass;
+    bodies.vz[index] += impulse.z * invMass;
+}
+
+// Stable orthonormal basis around the normal
+void computeTangents(const glm::vec3& normal, glm::vec3& tangent0, glm::vec3& tangent1)
+{
+    if (std::abs(normal.x) >= 0.57735f) {
+        tangent0 = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+    }
+    else {
+        tangent0 = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+    }
+    tangent1 = glm::cross(normal, tangent0);
+}
+
+}
+
+void ConstraintSolver::solve(std::vector<ContactManifold>& manifolds, BodyStore& bodies, float dt, TaskPool& pool)
+{
+    m_islands.clear();
+    m_largeIslands.clear();
+    m_colors.clear();
+    if (manifolds.empty() || dt <= 0.0f) return;
+
+    prepare(manifolds, bodies, dt, pool);
+    buildIslands(manifolds, bodies.size());
+
+    // Small islands share no bodies, each one runs start to finish on one task
+    pool.parallelFor(m_islands.size(), kIslandChunkSize, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const Batch& island = m_islands[i];
+            if (m_warmStarting) {
+                warmStart(manifolds, bodies, island.begin, island.end);
+            }
+            for (uint32_t iteration = 0; iteration < m_iterations; ++iteration) {
+                solveVelocities(manifolds, bodies, island.begin, island.end);
+            }
+        }
+        });
+
+    // Large islands go colour by colour, contacts of one colour in parallel
+    auto forEachColor = [&](const ColorRange& range, auto&& run) {
+        for (uint32_t c = range.begin; c < range.end; ++c) {
+            const Batch& color = m_colors[c];
+            size_t count = color.end - color.begin;
+            pool.parallelFor(count, color.serial ? count : kColorChunkSize, [&](size_t begin, size_t end, size_t) {
+                run(color.begin + static_cast<uint32_t>(begin), color.begin + static_cast<uint32_t>(end));
+                });
+        }
+    };
+    for (const ColorRange& range : m_largeIslands) {
+        if (m_warmStarting) {
+            forEachColor(range, [&](uint32_t begin, uint32_t end) { warmStart(manifolds, bodies, begin, end); });
+        }
+        for (uint32_t iteration = 0; iteration < m_iterations; ++iteration) {
+            forEachColor(range, [&](uint32_t begin, uint32_t end) { solveVelocities(manifolds, bodies, begin, end); });
+        }
+    }
+}
+
+void ConstraintSolver::prepare(std::vector<ContactManifold>& manifolds, const BodyStore& bodies, float dt, TaskPool& pool)
+{
+    pool.parallelFor(manifolds.size(), kPrepareChunkSize, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            ContactManifold& m = manifolds[i];
+            float invMassA = m.bodyA < 0 ? 0.0f : bodies.invMass[m.bodyA];
+            float invMassB = m.bodyB < 0 ? 0.0f : bodies.invMass[m.bodyB];
+            float invMassSum = invMassA + invMassB;
+
+            // Two immovable bodies or a trigger, nothing to solve
+            m.effectiveMass = invMassSum > 0.0f && !m.isTrigger ? 1.0f / invMassSum : 0.0f;
+
+            // Speculative contacts may close the gap this step but no more,
+            // penetrating ones push apart a fraction of the overlap
+            if (m.separation > 0.0f) {
+                m.targetVelocity = -m.separation / dt;
+            }
+            else {
+                m.targetVelocity = kBaumgarte * std::max(-m.separation - kLinearSlop, 0.0f) / dt;
+            }
+
+            computeTangents(m.normal, m.tangent[0], m.tangent[1]);
+
+            // Pairs with nothing to move this step (asleep, or just woken and not
+            // in the store yet) keep their impulses for when the island moves
+            // again. New pairs already arrive with zero from the ContactCache.
+            if (!m_warmStarting || m.isTrigger) {
+                m.normalImpulse = 0.0f;
+                m.tangentImpulse[0] = 0.0f;
+                m.tangentImpulse[1] = 0.0f;
+            }
+        }
+        });
+}
+
+void ConstraintSolver::buildIslands(const std::vector<ContactManifold>& manifolds, size_t bodyCount)
+{
+    // Only moving bodies join islands, statics (-1) touch any number of them
+    m_graph.begin(bodyCount);
+    for (const ContactManifold& m : manifolds) {
+        if (m.effectiveMass == 0.0f) continue;
+        if (m.bodyA >= 0 && m.bodyB >= 0) {
+            m_graph.link(m.bodyA, m.bodyB);
+        }
+    }
+
+    // Islands are numbered by their first contact, so the layout follows the
+    // sorted manifold order and never the union-find roots
+    m_islandOfRoot.assign(bodyCount, -1);
+    m_contactIsland.resize(manifolds.size());
+    m_islandOffsets.clear();
+    for (size_t i = 0; i < manifolds.size(); ++i) {
+        const ContactManifold& m = manifolds[i];
+        if (m.effectiveMass == 0.0f) {
+            m_contactIsland[i] = -1;
+            continue;
+        }
+
+        int32_t root = m_graph.find(m.bodyA >= 0 ? m.bodyA : m.bodyB);
+        if (m_islandOfRoot[root] < 0) {
+            m_islandOfRoot[root] = static_cast<int32_t>(m_islandOffsets.size());
+            m_islandOffsets.push_back(0);
+        }
+        m_contactIsland[i] = m_islandOfRoot[root];
+        ++m_islandOffsets[m_islandOfRoot[root]];
+    }
+
+    // Counting sort, contacts keep their order inside an island
+    uint32_t total = 0;
+    for (uint32_t& offset : m_islandOffsets) {
+        uint32_t count = offset;
+        offset = total;
+        total += count;
+    }
+    m_islandOffsets.push_back(total);
+
+    m_order.resize(total);
+    for (size_t i = 0; i < manifolds.size(); ++i) {
+        if (m_contactIsland[i] < 0) continue;
+        m_order[m_islandOffsets[m_contactIsland[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // The fill moved every offset to the start of the next island
+    uint32_t begin = 0;
+    for (size_t island = 0; island + 1 < m_islandOffsets.size(); ++island) {
+        Batch batch{ begin, m_islandOffsets[island] };
+        begin = batch.end;
+
+        if (batch.end - batch.begin >= kLargeIslandContacts) {
+            colorIsland(manifolds, batch);
+        }
+        else {
+            m_islands.push_back(batch);
+        }
+    }
+}
+
+void ConstraintSolver::colorIsland(const std::vector<ContactManifold>& manifolds, const Batch& island)
+{
+    m_bodyColors.resize(m_islandOfRoot.size());
+    for (uint32_t i = island.begin; i < island.end; ++i) {
+        const ContactManifold& m = manifolds[m_order[i]];
+        if (m.bodyA >= 0) m_bodyColors[m.bodyA] = 0;
+        if (m.bodyB >= 0) m_bodyColors[m.bodyB] = 0;
+    }
+
+    // Greedy, each contact takes the lowest colour neither body has used yet
+    uint32_t count = island.end - island.begin;
+    m_contactColors.resize(count);
+    m_colorOffsets.assign(kMaxColors + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        const ContactManifold& m = manifolds[m_order[island.begin + i]];
+        uint64_t used = (m.bodyA >= 0 ? m_bodyColors[m.bodyA] : 0) | (m.bodyB >= 0 ? m_bodyColors[m.bodyB] : 0);
+
+        uint32_t color = static_cast<uint32_t>(std::countr_one(used));
+        if (color < kMaxColors) {
+            uint64_t bit = uint64_t(1) << color;
+            if (m.bodyA >= 0) m_bodyColors[m.bodyA] |= bit;
+            if (m.bodyB >= 0) m_bodyColors[m.bodyB] |= bit;
+        }
+        m_contactColors[i] = static_cast<uint8_t>(color);
+        ++m_colorOffsets[color];
+    }
+
+    // Regroup the island by colour, keeping contact order inside each one
+    ColorRange range{ static_cast<uint32_t>(m_colors.size()), 0 };
+    uint32_t total = island.begin;
+    for (uint32_t color = 0; color <= kMaxColors; ++color) {
+        uint32_t colorCount = m_colorOffsets[color];
+        m_colorOffsets[color] = total - island.begin;
+        if (colorCount > 0) {
+            m_colors.push_back({ total, total + colorCount, color == kMaxColors });
+        }
+        total += colorCount;
+    }
+    range.end = static_cast<uint32_t>(m_colors.size());
+
+    m_colorScratch.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_colorScratch[m_colorOffsets[m_contactColors[i]]++] = m_order[island.begin + i];
+    }
+    std::copy(m_colorScratch.begin(), m_colorScratch.end(), m_order.begin() + island.begin);
+
+    m_largeIslands.push_back(range);
+}
+
+void ConstraintSolver::warmStart(const std::vector<ContactManifold>& manifolds, BodyStore& bodies, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i) {
+        const ContactManifold& m = manifolds[m_order[i]];
+
+        glm::vec3 impulse = m.normal * m.normalImpulse
+            + m.tangent[0] * m.tangentImpulse[0]
+            + m.tangent[1] * m.tangentImpulse[1];
+
+        applyImpulse(bodies, m.bodyA, -impulse);
+        applyImpulse(bodies, m.bodyB, impulse);
+    }
+}
+
+void ConstraintSolver::solveVelocities(std::vector<ContactManifold>& manifolds, BodyStore& bodies, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i) {
+        ContactManifold& m = manifolds[m_order[i]];
+
+        // Friction first, bounded by the current normal impulse
+        float maxFriction = m.friction * m.normalImpulse;
+        for (int t = 0; t < 2; ++t) {
+            glm::vec3 relative = loadVelocity(bodies, m.bodyB) - loadVelocity(bodies, m.bodyA);
+            float lambda = -glm::dot(relative, m.tangent[t]) * m.effectiveMass;
+
+            float accumulated = std::clamp(m.tangentImpulse[t] + lambda, -maxFriction, maxFriction);
+            lambda = accumulated - m.tangentImpulse[t];
+            m.tangentImpulse[t] = accumulated;
+
+            applyImpulse(bodies, m.bodyA, -m.tangent[t] * lambda);
+            applyImpulse(bodies, m.bodyB, m.tangent[t] * lambda);
+        }
+
+        // Non-penetration, the accumulated impulse may only push
+        glm::vec3 relative = loadVelocity(bodies, m.bodyB) - loadVelocity(bodies, m.bodyA);
+        float lambda = -(glm::dot(relative, m.normal) - m.targetVelocity) * m.effectiveMass;
+
+        float accumulated = std::max(m.normalImpulse + lambda, 0.0f);
+        lambda = accumulated - m.normalImpulse;
+        m.normalImpulse = accumulated;
+
+        applyImpulse(bodies, m.bodyA, -m.normal * lambda);
+        applyImpulse(bodies, m.bodyB, m.normal * lambda);
+    }
+}
@@ -0,0 +1,45 @@
+#include "ContactCache.hpp"
+#include <glm/glm.hpp>
+
+// Old impulses are only reused while the normal points roughly the same way
+constexpr float kWarmStartNormalDot = 0.95f;
+
+void ContactCache::update(std::vector<ContactManifold>& contacts)
+{
+    m_previous.swap(m_manifolds);
+    m_manifolds.clear();
+    m_manifolds.reserve(contacts.size());
+
+    // Both lists are sorted by pair id, walk them together
+    size_t old = 0;
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        ContactManifold& contact = contacts[i];
+
+        while (old < m_previous.size() && m_previous[old].pairId < contact.pairId) {
+            ++old;
+        }
+
+        const ContactManifold* cached = nullptr;
+        if (old < m_previous.size() && m_previous[old].pairId == contact.pairId &&
+            m_previous[old].entityA == contact.entityA && m_previous[old].entityB == contact.entityB) {
+            cached = &m_previous[old];
+        }
+
+        if (contact.asleep) {
+            if (cached) {
+                m_manifolds.push_back(*cached);
+                m_manifolds.back().asleep = true;
+                m_manifolds.back().bodyA = contact.bodyA;
+                m_manifolds.back().bodyB = contact.bodyB;
+            }
+            continue;
+        }
+
+        if (cached && glm::dot(cached->normal, contact.normal) > kWarmStartNormalDot) {
+            contact.normalImpulse = cached->normalImpulse;
+            contact.tangentImpulse[0] = cached->tangentImpulse[0];
+            contact.tangentImpulse[1] = cached->tangentImpulse[1];
+        }
+        m_manifolds.push_back(contact);
+    }
+}
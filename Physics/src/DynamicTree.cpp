@@ -0,0 +1,334 @@
+#include "DynamicTree.hpp"
+#include <algorithm>
+#include <cassert>
+
+DynamicTree::DynamicTree()
+{
+    m_nodes.reserve(64);
+}
+
+int32_t DynamicTree::allocateNode()
+{
+    // Grow the pool and thread the new nodes onto the free list
+    if (m_freeList == kNullNode) {
+        int32_t oldCapacity = static_cast<int32_t>(m_nodes.size());
+        int32_t newCapacity = std::max<int32_t>(16, oldCapacity * 2);
+        m_nodes.resize(newCapacity);
+
+        for (int32_t i = oldCapacity; i < newCapacity - 1; ++i) {
+            m_nodes[i].parent = i + 1;
+            m_nodes[i].height = -1;
+        }
+        m_nodes[newCapacity - 1].parent = kNullNode;
+        m_nodes[newCapacity - 1].height = -1;
+        m_freeList = oldCapacity;
+    }
+
+    int32_t nodeId = m_freeList;
+    TreeNode& node = m_nodes[nodeId];
+    m_freeList = node.parent;
+
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    node.userData = 0;
+    node.moved = false;
+    return nodeId;
+}
+
+void DynamicTree::freeNode(int32_t nodeId)
+{
+    m_nodes[nodeId].parent = m_freeList;
+    m_nodes[nodeId].height = -1;
+    m_freeList = nodeId;
+}
+
+int32_t DynamicTree::createProxy(const AABB& aabb, uint32_t userData)
+{
+    int32_t proxyId = allocateNode();
+
+    TreeNode& node = m_nodes[proxyId];
+    node.aabb = aabb.expanded(kAABBMargin);
+    node.userData = userData;
+    node.height = 0;
+    node.moved = true;
+
+    insertLeaf(proxyId);
+    ++m_proxyCount;
+    return proxyId;
+}
+
+void DynamicTree::destroyProxy(int32_t proxyId)
+{
+    assert(m_nodes[proxyId].isLeaf());
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --m_proxyCount;
+}
+
+bool DynamicTree::moveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement)
+{
+    TreeNode& node = m_nodes[proxyId];
+
+    // Predict the motion so fast bodies don't reinsert every step
+    AABB fatAABB = aabb.expanded(kAABBMargin);
+    glm::vec3 d = displacement * kAABBDisplacementMultiplier;
+    fatAABB.min = glm::min(fatAABB.min, fatAABB.min + d);
+    fatAABB.max = glm::max(fatAABB.max, fatAABB.max + d);
+
+    if (node.aabb.contains(aabb)) {
+        // Still inside; only reinsert if the fat box has become far too large
+        AABB hugeAABB = fatAABB.expanded(4.0f * kAABBMargin);
+        if (hugeAABB.contains(node.aabb)) {
+            return false;
+        }
+    }
+
+    removeLeaf(proxyId);
+    m_nodes[proxyId].aabb = fatAABB;
+    insertLeaf(proxyId);
+    m_nodes[proxyId].moved = true;
+    return true;
+}
+
+void DynamicTree::insertLeaf(int32_t leaf)
+{
+    if (m_root == kNullNode) {
+        m_root = leaf;
+        m_nodes[m_root].parent = kNullNode;
+        return;
+    }
+
+    // Find the best sibling using the surface area heuristic
+    AABB leafAABB = m_nodes[leaf].aabb;
+    int32_t index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        int32_t child1 = m_nodes[index].child1;
+        int32_t child2 = m_nodes[index].child2;
+
+        float area = m_nodes[index].aabb.getPerimeter();
+        float combinedArea = AABB::merge(m_nodes[index].aabb, leafAABB).getPerimeter();
+
+        // Cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            AABB merged = AABB::merge(leafAABB, m_nodes[child].aabb);
+            if (m_nodes[child].isLeaf()) {
+                return merged.getPerimeter() + inheritanceCost;
+            }
+            return merged.getPerimeter() - m_nodes[child].aabb.getPerimeter() + inheritanceCost;
+            };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+
+    // Create a new parent
+    int32_t oldParent = m_nodes[sibling].parent;
+    int32_t newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].userData = 0;
+    m_nodes[newParent].aabb = AABB::merge(leafAABB, m_nodes[sibling].aabb);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+
+    if (oldParent != kNullNode) {
+        if (m_nodes[oldParent].child1 == sibling) {
+            m_nodes[oldParent].child1 = newParent;
+        }
+        else {
+            m_nodes[oldParent].child2 = newParent;
+        }
+    }
+    else {
+        m_root = newParent;
+    }
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    // Walk back up the tree fixing heights and AABBs
+    index = m_nodes[leaf].parent;
+    while (index != kNullNode) {
+        index = balance(index);
+
+        int32_t child1 = m_nodes[index].child1;
+        int32_t child2 = m_nodes[index].child2;
+
+        m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+        m_nodes[index].aabb = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+
+        index = m_nodes[index].parent;
+    }
+}
+
+void DynamicTree::removeLeaf(int32_t leaf)
+{
+    if (leaf == m_root) {
+        m_root = kNullNode;
+        return;
+    }
+
+    int32_t parent = m_nodes[leaf].parent;
+    int32_t grandParent = m_nodes[parent].parent;
+    int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != kNullNode) {
+        // Destroy parent and connect sibling to grandParent
+        if (m_nodes[grandParent].child1 == parent) {
+            m_nodes[grandParent].child1 = sibling;
+        }
+        else {
+            m_nodes[grandParent].child2 = sibling;
+        }
+        m_nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int32_t index = grandParent;
+        while (index != kNullNode) {
+            index = balance(index);
+
+            int32_t child1 = m_nodes[index].child1;
+            int32_t child2 = m_nodes[index].child2;
+
+            m_nodes[index].aabb = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+            m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+
+            index = m_nodes[index].parent;
+        }
+    }
+    else {
+        m_root = sibling;
+        m_nodes[sibling].parent = kNullNode;
+        freeNode(parent);
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced, returns the new root index
+int32_t DynamicTree::balance(int32_t iA)
+{
+    TreeNode* A = &m_nodes[iA];
+    if (A->isLeaf() || A->height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A->child1;
+    int32_t iC = A->child2;
+    TreeNode* B = &m_nodes[iB];
+    TreeNode* C = &m_nodes[iC];
+
+    int32_t heightDiff = C->height - B->height;
+
+    // Rotate C up
+    if (heightDiff > 1) {
+        int32_t iF = C->child1;
+        int32_t iG = C->child2;
+        TreeNode* F = &m_nodes[iF];
+        TreeNode* G = &m_nodes[iG];
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        if (C->parent != kNullNode) {
+            if (m_nodes[C->parent].child1 == iA) {
+                m_nodes[C->parent].child1 = iC;
+            }
+            else {
+                m_nodes[C->parent].child2 = iC;
+            }
+        }
+        else {
+            m_root = iC;
+        }
+
+        if (F->height > G->height) {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->aabb = AABB::merge(B->aabb, G->aabb);
+            C->aabb = AABB::merge(A->aabb, F->aabb);
+
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        }
+        else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->aabb = AABB::merge(B->aabb, F->aabb);
+            C->aabb = AABB::merge(A->aabb, G->aabb);
+
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (heightDiff < -1) {
+        int32_t iD = B->child1;
+        int32_t iE = B->child2;
+        TreeNode* D = &m_nodes[iD];
+        TreeNode* E = &m_nodes[iE];
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        if (B->parent != kNullNode) {
+            if (m_nodes[B->parent].child1 == iA) {
+                m_nodes[B->parent].child1 = iB;
+            }
+            else {
+                m_nodes[B->parent].child2 = iB;
+            }
+        }
+        else {
+            m_root = iB;
+        }
+
+        if (D->height > E->height) {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->aabb = AABB::merge(C->aabb, E->aabb);
+            B->aabb = AABB::merge(A->aabb, D->aabb);
+
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        }
+        else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->aabb = AABB::merge(C->aabb, D->aabb);
+            B->aabb = AABB::merge(A->aabb, E->aabb);
+
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+int32_t DynamicTree::getHeight() const
+{
+    if (m_root == kNullNode) return 0;
+    return m_nodes[m_root].height;
+}
@@ -0,0 +1,86 @@
+#include "Heightfield.hpp"
+#include <stb_image.hpp>
+#include <algorithm>
+#include <cmath>
+
+Heightfield::Heightfield(uint32_t columns, uint32_t rows, std::vector<float> heights, const HeightfieldDesc& desc)
+    : m_heights(std::move(heights)),
+    m_columns(columns),
+    m_rows(rows),
+    m_origin(desc.origin),
+    m_spacing(desc.spacing),
+    m_invSpacing(1.0f / desc.spacing)
+{
+    if (m_heights.size() != static_cast<size_t>(columns) * rows) {
+        m_heights.clear();
+        m_columns = m_rows = 0;
+        return;
+    }
+
+    auto [minIt, maxIt] = std::minmax_element(m_heights.begin(), m_heights.end());
+    m_minHeight = minIt != m_heights.end() ? *minIt : 0.0f;
+    m_maxHeight = maxIt != m_heights.end() ? *maxIt : 0.0f;
+}
+
+bool Heightfield::loadFromImage(const std::string& path, const HeightfieldDesc& desc)
+{
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 1);
+    if (!data) return false;
+
+    std::vector<float> heights(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < heights.size(); ++i) {
+        heights[i] = static_cast<float>(data[i]) / 255.0f * desc.heightScale;
+    }
+    stbi_image_free(data);
+
+    *this = Heightfield(static_cast<uint32_t>(width), static_cast<uint32_t>(height), std::move(heights), desc);
+    return isValid();
+}
+
+void Heightfield::sample(float x, float z, float& height, glm::vec3& normal) const
+{
+    // Grid coordinates, clamped so the border cells extend outwards
+    float gx = std::clamp((x - m_origin.x) * m_invSpacing, 0.0f, static_cast<float>(m_columns - 1));
+    float gz = std::clamp((z - m_origin.z) * m_invSpacing, 0.0f, static_cast<float>(m_rows - 1));
+
+    uint32_t column = std::min(static_cast<uint32_t>(gx), m_columns - 2);
+    uint32_t row = std::min(static_cast<uint32_t>(gz), m_rows - 2);
+    float fx = gx - static_cast<float>(column);
+    float fz = gz - static_cast<float>(row);
+
+    float h00 = at(column, row);
+    float h10 = at(column + 1, row);
+    float h01 = at(column, row + 1);
+    float h11 = at(column + 1, row + 1);
+
+    // Slopes of the triangle the point falls in, per unit of world distance
+    float slopeX, slopeZ;
+    if (fx + fz <= 1.0f) {
+        height = h00 + (h10 - h00) * fx + (h01 - h00) * fz;
+        slopeX = h10 - h00;
+        slopeZ = h01 - h00;
+    }
+    else {
+        height = h11 + (h01 - h11) * (1.0f - fx) + (h10 - h11) * (1.0f - fz);
+        slopeX = h11 - h01;
+        slopeZ = h11 - h10;
+    }
+
+    height += m_origin.y;
+    normal = glm::normalize(glm::vec3(-slopeX * m_invSpacing, 1.0f, -slopeZ * m_invSpacing));
+}
+
+float Heightfield::getHeight(float x, float z) const
+{
+    float height;
+    glm::vec3 normal;
+    sample(x, z, height, normal);
+    return height;
+}
+
+AABB Heightfield::getBounds() const
+{
+    glm::vec3 extent(static_cast<float>(m_columns - 1) * m_spacing, 0.0f, static_cast<float>(m_rows - 1) * m_spacing);
+    return AABB(m_origin + glm::vec3(0.0f, m_minHeight, 0.0f), m_origin + extent + glm::vec3(0.0f, m_maxHeight, 0.0f));
+}
@@ -0,0 +1,227 @@
+#include "HierarchicalGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int32_t kMaxLevels = 16;
+constexpr int32_t kCellBits = 21;
+constexpr int32_t kCellLimit = (1 << (kCellBits - 1)) - 1;
+
+// Level sizes start at the size most proxies exceed, small outliers share cells
+constexpr float kBaseSizePercentile = 0.1f;
+constexpr float kMinCellSize = 1e-3f;
+
+} // namespace
+
+uint64_t HierarchicalGrid::makeCellKey(const CellCoord& coord)
+{
+    constexpr uint64_t mask = (1ull << kCellBits) - 1;
+    return ((static_cast<uint64_t>(coord.x + kCellLimit) & mask) << (2 * kCellBits)) |
+        ((static_cast<uint64_t>(coord.y + kCellLimit) & mask) << kCellBits) |
+        (static_cast<uint64_t>(coord.z + kCellLimit) & mask);
+}
+
+HierarchicalGrid::CellCoord HierarchicalGrid::getCell(const Level& level, const glm::vec3& point)
+{
+    auto toCell = [&](float value) {
+        float cell = std::floor(value * level.invCellSize);
+        return static_cast<int32_t>(std::clamp(cell, static_cast<float>(-kCellLimit), static_cast<float>(kCellLimit)));
+        };
+    return { toCell(point.x), toCell(point.y), toCell(point.z) };
+}
+
+float HierarchicalGrid::getSize(const AABB& aabb)
+{
+    glm::vec3 d = aabb.max - aabb.min;
+    return std::max(std::max(d.x, d.y), d.z);
+}
+
+bool HierarchicalGrid::outgrowsLevels(const AABB& aabb) const
+{
+    // Only worth a new layout if another level could still be added
+    return !m_levels.empty() && static_cast<int32_t>(m_levels.size()) < kMaxLevels &&
+        getSize(aabb) > 2.0f * m_levels.back().cellSize;
+}
+
+int32_t HierarchicalGrid::pickLevel(const AABB& aabb) const
+{
+    // Oversized proxies go to the top level and span more cells until the next layout
+    float ratio = getSize(aabb) / m_levels.front().cellSize;
+    if (ratio <= 1.0f) return 0;
+
+    int32_t level = static_cast<int32_t>(std::ceil(std::log2(ratio)));
+    return std::min(level, static_cast<int32_t>(m_levels.size()) - 1);
+}
+
+void HierarchicalGrid::addProxy(int32_t proxyId, const AABB& aabb)
+{
+    if (proxyId >= static_cast<int32_t>(m_boxes.size())) {
+        m_boxes.resize(proxyId + 1);
+    }
+
+    Box& box = m_boxes[proxyId];
+    box.aabb = aabb;
+    box.level = -1;
+    box.active = true;
+    ++m_proxyCount;
+
+    // Twice the proxies of the last layout may well have another size spread
+    if (m_proxyCount > 2 * m_layoutProxyCount || outgrowsLevels(aabb)) {
+        m_levelsDirty = true;
+    }
+    if (!m_levelsDirty) {
+        insert(proxyId);
+    }
+}
+
+void HierarchicalGrid::updateProxy(int32_t proxyId, const AABB& aabb)
+{
+    Box& box = m_boxes[proxyId];
+    if (box.level == -1) {
+        box.aabb = aabb;
+        return;
+    }
+
+    erase(proxyId);
+    box.aabb = aabb;
+    insert(proxyId);
+
+    if (outgrowsLevels(aabb)) {
+        m_levelsDirty = true;
+    }
+}
+
+void HierarchicalGrid::removeProxy(int32_t proxyId)
+{
+    Box& box = m_boxes[proxyId];
+    if (box.level != -1) {
+        erase(proxyId);
+    }
+    box.active = false;
+    --m_proxyCount;
+
+    if (2 * m_proxyCount < m_layoutProxyCount) {
+        m_levelsDirty = true;
+    }
+}
+
+void HierarchicalGrid::clear()
+{
+    m_levels.clear();
+    m_boxes.clear();
+    m_proxyCount = 0;
+    m_layoutProxyCount = 0;
+    m_occupiedCells = 0;
+    m_cellEntries = 0;
+    m_boundsBytes = 0;
+    m_levelsDirty = true;
+}
+
+bool HierarchicalGrid::updateLevels()
+{
+    if (!m_levelsDirty) return false;
+    m_levelsDirty = false;
+    m_layoutProxyCount = m_proxyCount;
+
+    std::vector<float> sizes;
+    sizes.reserve(m_proxyCount);
+    for (const Box& box : m_boxes) {
+        if (box.active) sizes.push_back(getSize(box.aabb));
+    }
+
+    // Powers of two from the small end of the size spread up to the largest proxy
+    float baseSize = 1.0f;
+    int32_t levelCount = 1;
+    if (!sizes.empty()) {
+        auto percentile = sizes.begin() + static_cast<size_t>(kBaseSizePercentile * (sizes.size() - 1));
+        std::nth_element(sizes.begin(), percentile, sizes.end());
+        baseSize = std::exp2(std::ceil(std::log2(std::max(*percentile, kMinCellSize))));
+
+        float largest = *std::max_element(sizes.begin(), sizes.end());
+        if (largest > baseSize) {
+            levelCount = static_cast<int32_t>(std::ceil(std::log2(largest / baseSize))) + 1;
+        }
+        levelCount = std::min(levelCount, kMaxLevels);
+    }
+
+    m_levels.clear();
+    m_levels.resize(levelCount);
+    for (int32_t i = 0; i < levelCount; ++i) {
+        m_levels[i].cellSize = baseSize * static_cast<float>(1u << i);
+        m_levels[i].invCellSize = 1.0f / m_levels[i].cellSize;
+    }
+
+    m_occupiedCells = 0;
+    m_cellEntries = 0;
+    m_boundsBytes = 0;
+    for (int32_t proxyId = 0; proxyId < static_cast<int32_t>(m_boxes.size()); ++proxyId) {
+        m_boxes[proxyId].level = -1;
+        if (m_boxes[proxyId].active) {
+            insert(proxyId);
+        }
+    }
+    return true;
+}
+
+void HierarchicalGrid::insert(int32_t proxyId)
+{
+    Box& box = m_boxes[proxyId];
+    box.level = pickLevel(box.aabb);
+
+    Level& level = m_levels[box.level];
+    box.minCell = getCell(level, box.aabb.min);
+    box.maxCell = getCell(level, box.aabb.max);
+    ++level.proxyCount;
+
+    for (int32_t x = box.minCell.x; x <= box.maxCell.x; ++x) {
+        for (int32_t y = box.minCell.y; y <= box.maxCell.y; ++y) {
+            for (int32_t z = box.minCell.z; z <= box.maxCell.z; ++z) {
+                Cell& cell = level.cells[makeCellKey({ x, y, z })];
+                if (cell.proxies.empty()) {
+                    cell.coord = { x, y, z };
+                    ++m_occupiedCells;
+                }
+                cell.proxies.push_back(proxyId);
+                size_t boundsBytes = cell.bounds.getMemoryUsage();
+                cell.bounds.add(box.aabb);
+                m_boundsBytes += cell.bounds.getMemoryUsage() - boundsBytes;
+                ++m_cellEntries;
+            }
+        }
+    }
+}
+
+void HierarchicalGrid::erase(int32_t proxyId)
+{
+    Box& box = m_boxes[proxyId];
+    Level& level = m_levels[box.level];
+    --level.proxyCount;
+
+    for (int32_t x = box.minCell.x; x <= box.maxCell.x; ++x) {
+        for (int32_t y = box.minCell.y; y <= box.maxCell.y; ++y) {
+            for (int32_t z = box.minCell.z; z <= box.maxCell.z; ++z) {
+                Cell& cell = level.cells[makeCellKey({ x, y, z })];
+                size_t index = static_cast<size_t>(std::find(cell.proxies.begin(), cell.proxies.end(), proxyId) - cell.proxies.begin());
+                cell.proxies[index] = cell.proxies.back();
+                cell.proxies.pop_back();
+                cell.bounds.removeSwap(index);
+                --m_cellEntries;
+                if (cell.proxies.empty()) --m_occupiedCells;
+            }
+        }
+    }
+    box.level = -1;
+}
+
+size_t HierarchicalGrid::getMemoryUsage() const
+{
+    // Walking every cell would cost more than the step, insert() keeps running totals instead
+    size_t bytes = m_boxes.capacity() * sizeof(Box) + m_levels.capacity() * sizeof(Level);
+    for (const Level& level : m_levels) {
+        bytes += level.cells.bucket_count() * sizeof(void*);
+        bytes += level.cells.size() * (sizeof(std::pair<const uint64_t, Cell>) + sizeof(void*));
+    }
+    bytes += m_cellEntries * sizeof(int32_t) + m_boundsBytes;
+    return bytes;
+}
@@ -0,0 +1,99 @@
+#include "IslandManager.hpp"
+#include <algorithm>
+#include <numeric>
+
+void IslandManager::begin(size_t bodyCount)
+{
+    m_parent.resize(bodyCount);
+    m_rank.assign(bodyCount, 0);
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+}
+
+int32_t IslandManager::find(int32_t body)
+{
+    // Path halving
+    while (m_parent[body] != body) {
+        m_parent[body] = m_parent[m_parent[body]];
+        body = m_parent[body];
+    }
+    return body;
+}
+
+void IslandManager::link(int32_t bodyA, int32_t bodyB)
+{
+    int32_t rootA = find(bodyA);
+    int32_t rootB = find(bodyB);
+    if (rootA == rootB) return;
+
+    if (m_rank[rootA] < m_rank[rootB]) std::swap(rootA, rootB);
+    m_parent[rootB] = rootA;
+    if (m_rank[rootA] == m_rank[rootB]) ++m_rank[rootA];
+}
+
+int32_t IslandManager::createSleepingIsland()
+{
+    if (!m_freeIslands.empty()) {
+        int32_t islandId = m_freeIslands.back();
+        m_freeIslands.pop_back();
+        return islandId;
+    }
+
+    m_sleepingIslands.emplace_back();
+    return static_cast<int32_t>(m_sleepingIslands.size() - 1);
+}
+
+void IslandManager::addToSleepingIsland(int32_t islandId, uint32_t member)
+{
+    m_sleepingIslands[islandId].push_back(member);
+}
+
+void IslandManager::removeFromSleepingIsland(int32_t islandId, uint32_t member)
+{
+    auto& members = m_sleepingIslands[islandId];
+    auto it = std::find(members.begin(), members.end(), member);
+    if (it != members.end()) {
+        *it = members.back();
+        members.pop_back();
+    }
+
+    if (members.empty()) {
+        releaseSleepingIsland(islandId);
+    }
+}
+
+void IslandManager::releaseSleepingIsland(int32_t islandId)
+{
+    m_sleepingIslands[islandId].clear();
+    m_freeIslands.push_back(islandId);
+}
+
+void IslandManager::saveSleepingIslands(std::vector<uint32_t>& offsets, std::vector<uint32_t>& members, std::vector<int32_t>& freeIslands) const
+{
+    offsets.clear();
+    members.clear();
+    for (const auto& island : m_sleepingIslands) {
+        offsets.push_back(static_cast<uint32_t>(members.size()));
+        members.insert(members.end(), island.begin(), island.end());
+    }
+    offsets.push_back(static_cast<uint32_t>(members.size()));
+    freeIslands = m_freeIslands;
+}
+
+void IslandManager::loadSleepingIslands(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& members, const std::vector<int32_t>& freeIslands)
+{
+    // Islands keep their ids, bodies refer to them by index
+    size_t islandCount = offsets.empty() ? 0 : offsets.size() - 1;
+    m_sleepingIslands.resize(islandCount);
+    for (size_t i = 0; i < islandCount; ++i) {
+        m_sleepingIslands[i].assign(members.begin() + offsets[i], members.begin() + offsets[i + 1]);
+    }
+    m_freeIslands = freeIslands;
+}
+
+void IslandManager::clear()
+{
+    m_parent.clear();
+    m_rank.clear();
+    m_sleepingIslands.clear();
+    m_freeIslands.clear();
+}
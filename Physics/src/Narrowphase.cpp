@@ -0,0 +1,577 @@
+#include "Narrowphase.hpp"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+constexpr float kEpsilon = 1e-6f;
+
+using CollideFn = bool(*)(const ShapeInstance&, const ShapeInstance&, float, ContactManifold&);
+
+glm::vec3 safeNormal(const glm::vec3& d, float length)
+{
+    return length > kEpsilon ? d / length : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+// Closest point to p on segment [a, b]
+glm::vec3 closestOnSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+{
+    glm::vec3 ab = b - a;
+    float lengthSq = glm::dot(ab, ab);
+    if (lengthSq < kEpsilon) return a;
+    float t = std::clamp(glm::dot(p - a, ab) / lengthSq, 0.0f, 1.0f);
+    return a + ab * t;
+}
+
+// Closest points between segments [p1, q1] and [p2, q2] (Ericson 5.1.9)
+void closestBetweenSegments(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2,
+    glm::vec3& c1, glm::vec3& c2)
+{
+    glm::vec3 d1 = q1 - p1;
+    glm::vec3 d2 = q2 - p2;
+    glm::vec3 r = p1 - p2;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+    float s = 0.0f;
+    float t = 0.0f;
+
+    if (a <= kEpsilon && e <= kEpsilon) {
+        c1 = p1;
+        c2 = p2;
+        return;
+    }
+
+    if (a <= kEpsilon) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    }
+    else {
+        float c = glm::dot(d1, r);
+        if (e <= kEpsilon) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else {
+            float b = glm::dot(d1, d2);
+            float denom = a * e - b * b;
+            s = denom > kEpsilon ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+// Two spheres given by centers and radii, the building block of the round shapes
+bool collideSpheres(const glm::vec3& centerA, float radiusA, const glm::vec3& centerB, float radiusB,
+    float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 d = centerB - centerA;
+    float distanceSq = glm::dot(d, d);
+    float reach = radiusA + radiusB + maxSeparation;
+    if (distanceSq > reach * reach) return false;
+
+    float distance = std::sqrt(distanceSq);
+    contact.normal = safeNormal(d, distance);
+    contact.separation = distance - radiusA - radiusB;
+    return true;
+}
+
+// Sphere against box in the box's local frame
+bool collideBoxPoint(const ShapeInstance& box, const glm::vec3& point, float radius, float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 local = glm::transpose(box.rotation) * (point - box.center);
+    glm::vec3 clamped = glm::clamp(local, -box.halfExtents, box.halfExtents);
+    glm::vec3 d = local - clamped;
+    float distanceSq = glm::dot(d, d);
+
+    if (distanceSq > kEpsilon * kEpsilon) {
+        float reach = radius + maxSeparation;
+        if (distanceSq > reach * reach) return false;
+
+        float distance = std::sqrt(distanceSq);
+        contact.normal = box.rotation * (d / distance);
+        contact.separation = distance - radius;
+        return true;
+    }
+
+    // Center inside the box, push out through the nearest face
+    int axis = 0;
+    float faceDistance = FLT_MAX;
+    for (int k = 0; k < 3; ++k) {
+        float distanceToFace = box.halfExtents[k] - std::abs(local[k]);
+        if (distanceToFace < faceDistance) {
+            faceDistance = distanceToFace;
+            axis = k;
+        }
+    }
+    contact.normal = box.rotation[axis] * (local[axis] < 0.0f ? -1.0f : 1.0f);
+    contact.separation = -(faceDistance + radius);
+    return true;
+}
+
+// --- Pair tests, a is always the first shape ---
+
+bool sphereSphere(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    return collideSpheres(a.center, a.radius, b.center, b.radius, maxSeparation, contact);
+}
+
+bool boxSphere(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    return collideBoxPoint(a, b.center, b.radius, maxSeparation, contact);
+}
+
+bool capsuleSphere(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 closest = closestOnSegment(b.center, a.getSegmentA(), a.getSegmentB());
+    return collideSpheres(closest, a.radius, b.center, b.radius, maxSeparation, contact);
+}
+
+bool capsuleCapsule(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 closestA, closestB;
+    closestBetweenSegments(a.getSegmentA(), a.getSegmentB(), b.getSegmentA(), b.getSegmentB(), closestA, closestB);
+    return collideSpheres(closestA, a.radius, closestB, b.radius, maxSeparation, contact);
+}
+
+// Projection radius of a box onto an axis
+float projectBox(const ShapeInstance& box, const glm::vec3& axis)
+{
+    return box.halfExtents.x * std::abs(glm::dot(box.rotation[0], axis))
+        + box.halfExtents.y * std::abs(glm::dot(box.rotation[1], axis))
+        + box.halfExtents.z * std::abs(glm::dot(box.rotation[2], axis));
+}
+
+// Separating axis test over the 15 OBB axes, keeps the axis of least overlap
+bool boxBox(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 d = b.center - a.center;
+    float bestOverlap = FLT_MAX;
+    glm::vec3 bestAxis(0.0f, 1.0f, 0.0f);
+
+    auto testAxis = [&](glm::vec3 axis) {
+        float lengthSq = glm::dot(axis, axis);
+        // Edge pairs that are parallel give no axis, a face axis covers them
+        if (lengthSq < kEpsilon) return true;
+        axis /= std::sqrt(lengthSq);
+
+        float distance = glm::dot(d, axis);
+        float overlap = projectBox(a, axis) + projectBox(b, axis) - std::abs(distance);
+        if (overlap < -maxSeparation) return false;
+
+        // Prefer face axes on ties so resting boxes get stable normals
+        if (overlap < bestOverlap - kEpsilon) {
+            bestOverlap = overlap;
+            bestAxis = distance < 0.0f ? -axis : axis;
+        }
+        return true;
+        };
+
+    for (int i = 0; i < 3; ++i) {
+        if (!testAxis(a.rotation[i])) return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (!testAxis(b.rotation[i])) return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (!testAxis(glm::cross(a.rotation[i], b.rotation[j]))) return false;
+        }
+    }
+
+    contact.normal = bestAxis;
+    contact.separation = -bestOverlap;
+    return true;
+}
+
+// Squared distance from a point to the box, local frame
+float distanceSqToBox(const glm::vec3& point, const glm::vec3& halfExtents)
+{
+    glm::vec3 d = point - glm::clamp(point, -halfExtents, halfExtents);
+    return glm::dot(d, d);
+}
+
+// How far a point is inside the box, negative outside
+float depthInBox(const glm::vec3& point, const glm::vec3& halfExtents)
+{
+    return std::min({ halfExtents.x - std::abs(point.x), halfExtents.y - std::abs(point.y),
+        halfExtents.z - std::abs(point.z) });
+}
+
+// Point of segment [p, q] closest to the box, both in the box's local frame.
+// Outside, the squared distance along the segment is a convex quadratic
+// between the points where a coordinate crosses a face plane, each piece
+// is minimised in closed form. A segment through the box gets its deepest
+// point instead. Depth is piecewise linear in the segment parameter, so the
+// maximum is at an end, where a coordinate crosses zero, or where two face
+// distances are equal.
+glm::vec3 closestOnSegmentToBox(const glm::vec3& p, const glm::vec3& q, const glm::vec3& halfExtents)
+{
+    glm::vec3 d = q - p;
+
+    std::array<float, 8> breaks;
+    size_t breakCount = 0;
+    breaks[breakCount++] = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+        if (std::abs(d[k]) < kEpsilon) continue;
+        for (float side : { -1.0f, 1.0f }) {
+            float t = (side * halfExtents[k] - p[k]) / d[k];
+            if (t > 0.0f && t < 1.0f) breaks[breakCount++] = t;
+        }
+    }
+    breaks[breakCount++] = 1.0f;
+    std::sort(breaks.begin(), breaks.begin() + breakCount);
+
+    float bestT = 0.0f;
+    float bestDistanceSq = FLT_MAX;
+    for (size_t i = 0; i + 1 < breakCount; ++i) {
+        float t0 = breaks[i];
+        float t1 = breaks[i + 1];
+
+        // The faces a point of this piece is clamped to stay the same over it
+        glm::vec3 middle = p + d * (0.5f * (t0 + t1));
+        float slope = 0.0f;
+        float curvature = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            if (std::abs(middle[k]) <= halfExtents[k]) continue;
+            float face = middle[k] < 0.0f ? -halfExtents[k] : halfExtents[k];
+            slope += (p[k] - face) * d[k];
+            curvature += d[k] * d[k];
+        }
+        float t = curvature > 0.0f ? std::clamp(-slope / curvature, t0, t1) : t0;
+
+        float distanceSq = distanceSqToBox(p + d * t, halfExtents);
+        if (distanceSq < bestDistanceSq) {
+            bestDistanceSq = distanceSq;
+            bestT = t;
+        }
+    }
+    if (bestDistanceSq > kEpsilon * kEpsilon) return p + d * bestT;
+
+    float bestDepth = -FLT_MAX;
+    auto tryDepth = [&](float t) {
+        if (!(t >= 0.0f && t <= 1.0f)) return;
+        float depth = depthInBox(p + d * t, halfExtents);
+        if (depth > bestDepth) {
+            bestDepth = depth;
+            bestT = t;
+        }
+        };
+    tryDepth(0.0f);
+    tryDepth(1.0f);
+    for (int i = 0; i < 3; ++i) {
+        if (std::abs(d[i]) > kEpsilon) tryDepth(-p[i] / d[i]);
+
+        // halfExtents[i] - si * x_i(t) == halfExtents[j] - sj * x_j(t)
+        for (int j = i + 1; j < 3; ++j) {
+            for (float si : { -1.0f, 1.0f }) {
+                for (float sj : { -1.0f, 1.0f }) {
+                    float rate = si * d[i] - sj * d[j];
+                    if (std::abs(rate) < kEpsilon) continue;
+                    tryDepth((halfExtents[i] - halfExtents[j] - si * p[i] + sj * p[j]) / rate);
+                }
+            }
+        }
+    }
+    return p + d * bestT;
+}
+
+bool boxCapsule(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::mat3 toLocal = glm::transpose(a.rotation);
+    glm::vec3 segmentA = toLocal * (b.getSegmentA() - a.center);
+    glm::vec3 segmentB = toLocal * (b.getSegmentB() - a.center);
+
+    glm::vec3 onSegment = closestOnSegmentToBox(segmentA, segmentB, a.halfExtents);
+    return collideBoxPoint(a, a.center + a.rotation * onSegment, b.radius, maxSeparation, contact);
+}
+
+// Closest point to p on triangle abc (Ericson 5.1.5)
+glm::vec3 closestOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Round shape (a point or segment swept by radius) against one triangle, all
+// in the mesh frame. Normal points from the triangle to the shape.
+bool collideTriangleRound(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c,
+    const glm::vec3& p, const glm::vec3& q, float radius, float maxSeparation, glm::vec3& normal, float& separation)
+{
+    glm::vec3 face = glm::normalize(glm::cross(b - a, c - a));
+    float distP = glm::dot(p - a, face);
+    float distQ = glm::dot(q - a, face);
+
+    // A segment through the triangle touches it, push out on the side of its middle
+    if (distP * distQ < 0.0f) {
+        float t = distP / (distP - distQ);
+        glm::vec3 crossing = p + (q - p) * t;
+        if (glm::length(closestOnTriangle(crossing, a, b, c) - crossing) < kEpsilon) {
+            float side = distP + distQ < 0.0f ? -1.0f : 1.0f;
+            normal = face * side;
+            separation = std::min(distP * side, distQ * side) - radius;
+            return true;
+        }
+    }
+
+    // Otherwise the closest pair has an end point or a triangle edge in it
+    glm::vec3 bestShape = p;
+    glm::vec3 bestTriangle = closestOnTriangle(p, a, b, c);
+    float bestSq = glm::dot(p - bestTriangle, p - bestTriangle);
+    auto consider = [&](const glm::vec3& onShape, const glm::vec3& onTriangle) {
+        float distanceSq = glm::dot(onShape - onTriangle, onShape - onTriangle);
+        if (distanceSq < bestSq) {
+            bestSq = distanceSq;
+            bestShape = onShape;
+            bestTriangle = onTriangle;
+        }
+        };
+    if (q != p) {
+        consider(q, closestOnTriangle(q, a, b, c));
+        const glm::vec3 edges[3][2] = { { a, b }, { b, c }, { c, a } };
+        for (const auto& edge : edges) {
+            glm::vec3 onSegment, onEdge;
+            closestBetweenSegments(p, q, edge[0], edge[1], onSegment, onEdge);
+            consider(onSegment, onEdge);
+        }
+    }
+
+    float distance = std::sqrt(bestSq);
+    if (distance > radius + maxSeparation) return false;
+
+    if (distance > kEpsilon) {
+        normal = (bestShape - bestTriangle) / distance;
+    }
+    else {
+        normal = glm::dot(bestShape - a, face) < 0.0f ? -face : face;
+    }
+    separation = distance - radius;
+    return true;
+}
+
+// Shape given in the mesh frame against every triangle near it, the deepest wins
+template<typename TriangleTest>
+bool collideMeshTriangles(const ShapeInstance& mesh, const AABB& localBounds, ContactManifold& contact, TriangleTest&& test)
+{
+    if (!mesh.mesh) return false;
+
+    bool found = false;
+    float bestSeparation = FLT_MAX;
+    glm::vec3 bestNormal(0.0f, 1.0f, 0.0f);
+
+    mesh.mesh->query(localBounds, [&](uint32_t triangle) {
+        glm::vec3 a, b, c;
+        mesh.mesh->getTriangle(triangle, a, b, c);
+
+        glm::vec3 normal;
+        float separation;
+        if (test(a, b, c, normal, separation) && separation < bestSeparation) {
+            bestSeparation = separation;
+            bestNormal = normal;
+            found = true;
+        }
+        return true;
+        });
+
+    if (!found) return false;
+    contact.normal = mesh.rotation * bestNormal;
+    contact.separation = bestSeparation;
+    return true;
+}
+
+bool meshSphere(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::vec3 center = glm::transpose(a.rotation) * (b.center - a.center);
+    AABB bounds = AABB::fromCenterExtents(center, glm::vec3(b.radius + maxSeparation));
+
+    return collideMeshTriangles(a, bounds, contact, [&](const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& normal, float& separation) {
+        return collideTriangleRound(v0, v1, v2, center, center, b.radius, maxSeparation, normal, separation);
+        });
+}
+
+bool meshCapsule(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::mat3 toLocal = glm::transpose(a.rotation);
+    glm::vec3 p = toLocal * (b.getSegmentA() - a.center);
+    glm::vec3 q = toLocal * (b.getSegmentB() - a.center);
+    AABB bounds = AABB(glm::min(p, q), glm::max(p, q)).expanded(b.radius + maxSeparation);
+
+    return collideMeshTriangles(a, bounds, contact, [&](const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& normal, float& separation) {
+        return collideTriangleRound(v0, v1, v2, p, q, b.radius, maxSeparation, normal, separation);
+        });
+}
+
+// Separating axis test of the box against each triangle: 3 box faces, the
+// triangle face and the 9 edge pairs. Touching triangles push along their
+// face normal, edge axes of neighbouring triangles would otherwise catch the
+// box on the seams and push it sideways.
+bool meshBox(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    glm::mat3 toLocal = glm::transpose(a.rotation);
+    ShapeInstance box = b;
+    box.center = toLocal * (b.center - a.center);
+    box.rotation = toLocal * b.rotation;
+    AABB bounds = box.computeAABB().expanded(maxSeparation);
+
+    return collideMeshTriangles(a, bounds, contact, [&](const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, glm::vec3& normal, float& separation) {
+        auto separated = [&](glm::vec3 axis) {
+            float lengthSq = glm::dot(axis, axis);
+            if (lengthSq < kEpsilon) return false;
+            axis /= std::sqrt(lengthSq);
+
+            float p0 = glm::dot(v0, axis), p1 = glm::dot(v1, axis), p2 = glm::dot(v2, axis);
+            float center = glm::dot(box.center, axis);
+            float radius = projectBox(box, axis);
+            float overlap = std::min(std::max(std::max(p0, p1), p2) - (center - radius), (center + radius) - std::min(std::min(p0, p1), p2));
+            return overlap < -maxSeparation;
+            };
+
+        glm::vec3 edges[3] = { v1 - v0, v2 - v1, v0 - v2 };
+        for (int i = 0; i < 3; ++i) {
+            if (separated(box.rotation[i])) return false;
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                if (separated(glm::cross(box.rotation[i], edges[j]))) return false;
+            }
+        }
+
+        // Face side of the box center, then its distance past the plane
+        glm::vec3 face = glm::normalize(glm::cross(edges[0], edges[1]));
+        float height = glm::dot(box.center - v0, face);
+        normal = height < 0.0f ? -face : face;
+        separation = std::abs(height) - projectBox(box, face);
+        return separation <= maxSeparation;
+        });
+}
+
+// Meshes are static, two of them never need a contact
+bool meshMesh(const ShapeInstance&, const ShapeInstance&, float, ContactManifold&)
+{
+    return false;
+}
+
+// Reversed pairs reuse the test above with the shapes swapped
+template<CollideFn Fn>
+bool flipped(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    if (!Fn(b, a, maxSeparation, contact)) return false;
+    contact.normal = -contact.normal;
+    return true;
+}
+
+constexpr size_t kShapeTypeCount = 4;
+
+// Indexed by [ColliderType of a][ColliderType of b], in enum order Box, Sphere, Capsule, Mesh
+constexpr std::array<std::array<CollideFn, kShapeTypeCount>, kShapeTypeCount> kDispatchTable = { {
+    { boxBox,                  boxSphere,                  boxCapsule,                flipped<meshBox> },
+    { flipped<boxSphere>,      sphereSphere,               flipped<capsuleSphere>,    flipped<meshSphere> },
+    { flipped<boxCapsule>,     capsuleSphere,              capsuleCapsule,            flipped<meshCapsule> },
+    { meshBox,                 meshSphere,                 meshCapsule,               meshMesh },
+} };
+
+static_assert(static_cast<size_t>(ColliderType::Box) == 0 &&
+    static_cast<size_t>(ColliderType::Sphere) == 1 &&
+    static_cast<size_t>(ColliderType::Capsule) == 2 &&
+    static_cast<size_t>(ColliderType::Mesh) == 3, "kDispatchTable follows the ColliderType order");
+
+}
+
+glm::mat3 rotationFromEuler(const glm::vec3& degrees)
+{
+    glm::vec3 radians = glm::radians(degrees);
+    float cx = std::cos(radians.x), sx = std::sin(radians.x);
+    float cy = std::cos(radians.y), sy = std::sin(radians.y);
+    float cz = std::cos(radians.z), sz = std::sin(radians.z);
+
+    // Rx * Ry * Rz, column major
+    glm::mat3 rotation;
+    rotation[0] = glm::vec3(cy * cz, sx * sy * cz + cx * sz, -cx * sy * cz + sx * sz);
+    rotation[1] = glm::vec3(-cy * sz, -sx * sy * sz + cx * cz, cx * sy * sz + sx * cz);
+    rotation[2] = glm::vec3(sy, -sx * cy, cx * cy);
+    return rotation;
+}
+
+ShapeInstance ShapeInstance::fromCollider(const Collider& col, const glm::vec3& position, const glm::vec3& rotationDegrees)
+{
+    ShapeInstance shape;
+    shape.type = col.type;
+    shape.rotation = rotationFromEuler(rotationDegrees);
+    shape.center = position + shape.rotation * col.offset;
+    shape.halfExtents = col.size * 0.5f;
+    shape.radius = col.size.x * 0.5f;
+    shape.halfHeight = col.type == ColliderType::Capsule ? std::max(col.size.y * 0.5f - shape.radius, 0.0f) : 0.0f;
+    shape.mesh = col.type == ColliderType::Mesh ? col.getMesh() : nullptr;
+    return shape;
+}
+
+AABB ShapeInstance::computeAABB() const
+{
+    switch (type) {
+    case ColliderType::Sphere:
+        return AABB::fromCenterExtents(center, glm::vec3(radius));
+    case ColliderType::Capsule: {
+        glm::vec3 axis = glm::abs(rotation[1] * halfHeight);
+        return AABB::fromCenterExtents(center, axis + glm::vec3(radius));
+    }
+    case ColliderType::Mesh: {
+        if (!mesh) return AABB(center, center);
+        const AABB& local = mesh->getBounds();
+        glm::vec3 localExtents = local.getExtents();
+        glm::vec3 extents = glm::abs(rotation[0]) * localExtents.x
+            + glm::abs(rotation[1]) * localExtents.y
+            + glm::abs(rotation[2]) * localExtents.z;
+        return AABB::fromCenterExtents(center + rotation * local.getCenter(), extents);
+    }
+    case ColliderType::Box:
+    default: {
+        glm::vec3 extents = glm::abs(rotation[0]) * halfExtents.x
+            + glm::abs(rotation[1]) * halfExtents.y
+            + glm::abs(rotation[2]) * halfExtents.z;
+        return AABB::fromCenterExtents(center, extents);
+    }
+    }
+}
+
+bool collideShapes(const ShapeInstance& a, const ShapeInstance& b, float maxSeparation, ContactManifold& contact)
+{
+    CollideFn fn = kDispatchTable[static_cast<size_t>(a.type)][static_cast<size_t>(b.type)];
+    return fn(a, b, maxSeparation, contact);
+}
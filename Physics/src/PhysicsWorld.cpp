@@ -1,4 +1,56 @@
 #include "PhysicsWorld.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Pairs per narrowphase task
+constexpr size_t kPairChunkSize = 256;
+
+// Ray packets per query task
+constexpr size_t kRayPacketChunkSize = 16;
+
+// Contacts are created this far before touching so the solver can stop approaching bodies
+constexpr float kSpeculativeDistance = 0.1f;
+// Pair key id standing in for the floor plane
+constexpr uint32_t kGroundId = UINT32_MAX;
+// Contacts closer than this count as touching for events
+constexpr float kTouchingDistance = 0.01f;
+
+// Bodies slower than this for kTimeToSleep seconds put their island to sleep
+constexpr float kLinearSleepTolerance = 0.05f;
+constexpr float kTimeToSleep = 0.5f;
+
+// Surfaces a character move may slide along before the rest is dropped
+constexpr uint32_t kMaxCharacterSlides = 4;
+// Conservative advancement steps per slide
+constexpr uint32_t kMaxCharacterAdvances = 16;
+
+namespace {
+
+// Gathers every mesh of the model into one triangle list, scaled like the
+// rendered model, and builds it. Runs on a pool worker so neither the copy
+// nor the build holds up the step.
+TriangleMeshFuture buildModelMesh(TaskPool& pool, std::shared_ptr<ThreadSafeModel> model, glm::vec3 scale)
+{
+	return TriangleMesh::buildAsync(pool, [model = std::move(model), scale]() {
+		std::vector<glm::vec3> vertices;
+		std::vector<uint32_t> indices;
+		model->Visit([&](const Model& loaded) {
+			for (const Mesh& mesh : loaded.getMeshes()) {
+				uint32_t base = static_cast<uint32_t>(vertices.size());
+				for (const Vertex& vertex : mesh.vertices) {
+					vertices.push_back(vertex.Position * scale);
+				}
+				for (unsigned int index : mesh.indices) {
+					indices.push_back(base + index);
+				}
+			}
+			});
+		return std::shared_ptr<const TriangleMesh>(std::make_shared<TriangleMesh>(std::move(vertices), std::move(indices)));
+		});
+}
+
+}
 
 PhysicsWorld::PhysicsWorld() : m_Scene(nullptr)
 {
@@ -7,288 +59,1501 @@ PhysicsWorld::PhysicsWorld() : m_Scene(nullptr)
 
 PhysicsWorld::PhysicsWorld(Scene* scene) : m_Scene(scene)
 {
-
+	connectScene();
 }
 void PhysicsWorld::SetScene(Scene* scene)
 {
+	bool threaded = m_threaded;
+	setThreaded(false);
+
+	disconnectScene();
 	m_Scene = scene;
+	m_broadphase = Broadphase();
+	m_islands.clear();
+	m_contactCache.clear();
+	m_touching.clear();
+	m_previousTouching.clear();
+	m_contactEvents.clear();
+	m_modelMeshScales.clear();
+	connectScene();
+
+	setThreaded(threaded);
+}
+
+void PhysicsWorld::setThreadCount(uint32_t threadCount)
+{
+	// The calling thread always takes part
+	m_taskPool.setWorkerCount(threadCount == 0 ? TaskPool::kHardwareWorkers : threadCount - 1);
+}
+
+void PhysicsWorld::setSleepingEnabled(bool enabled)
+{
+	m_allowSleeping = enabled;
+	if (enabled || !m_Scene) return;
+
+	m_Scene->GetRegistry().view<RigidBody>().each([&](RigidBody& body) {
+		wakeIsland(body);
+		});
+	for (BodySlot& slot : m_worldBodies) {
+		wakeIsland(slot.body);
+	}
+}
+
+void PhysicsWorld::setSolverIterations(uint32_t iterations)
+{
+	m_solver.setIterations(iterations);
+}
+
+void PhysicsWorld::setWarmStarting(bool enabled)
+{
+	m_solver.setWarmStarting(enabled);
+}
+
+void PhysicsWorld::setHeightfield(std::shared_ptr<const Heightfield> heightfield)
+{
+	m_heightfield = heightfield && heightfield->isValid() ? std::move(heightfield) : nullptr;
+
+	// Resting bodies would keep floating where the old ground was
+	if (!m_Scene) return;
+	m_Scene->GetRegistry().view<RigidBody>().each([&](RigidBody& body) {
+		wakeIsland(body);
+		});
+	for (BodySlot& slot : m_worldBodies) {
+		wakeIsland(slot.body);
+	}
+}
+
+size_t PhysicsWorld::getMemoryUsage() const
+{
+	size_t bytes = m_broadphase.getMemoryUsage() + m_bodyStore.getMemoryUsage() + m_contactCache.getMemoryUsage();
+	bytes += m_worldBodies.getMemoryUsage() + m_worldColliders.getMemoryUsage();
+	bytes += m_simBodies.capacity() * sizeof(SimBody) + m_proxyOwners.getMemoryUsage();
+	bytes += m_proxyShapes.getMemoryUsage() + m_proxyBounds.getMemoryUsage();
+	bytes += (m_contacts.capacity() + m_triggerContacts.capacity()) * sizeof(ContactManifold);
+	for (const auto& chunk : m_chunkContacts) {
+		bytes += chunk.capacity() * sizeof(ContactManifold);
+	}
+	bytes += (m_touching.capacity() + m_previousTouching.capacity()) * sizeof(TouchingPair);
+	bytes += m_contactEvents.capacity() * sizeof(ContactEvent);
+	if (m_heightfield) bytes += m_heightfield->getMemoryUsage();
+	return bytes;
+}
+
+void PhysicsWorld::setBroadphaseType(BroadphaseType type)
+{
+	m_broadphase.setType(type);
+}
+
+void PhysicsWorld::connectScene()
+{
+	if (!m_Scene) return;
+
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	// Proxies and islands belong to this world, forget any from a previous one
+	reg.view<Collider>().each([](Collider& col) {
+		col.proxyId = -1;
+		});
+	reg.view<RigidBody>().each([](RigidBody& body) {
+		body.isSleeping = false;
+		body.islandId = -1;
+		});
+
+	// World owned bodies follow the world into the new scene
+	for (size_t i = 0; i < m_worldBodies.size(); ++i) {
+		BodySlot& slot = m_worldBodies[i];
+		slot.body.isSleeping = false;
+		slot.body.islandId = -1;
+		slot.entity = reg.create();
+		reg.emplace<WorldBody>(slot.entity, m_worldBodies.getHandle(i));
+	}
+	for (ColliderSlot& slot : m_worldColliders) {
+		slot.collider.proxyId = -1;
+	}
+
+	reg.on_destroy<Collider>().connect<&PhysicsWorld::onColliderDestroyed>(this);
+	reg.on_destroy<RigidBody>().connect<&PhysicsWorld::onRigidBodyDestroyed>(this);
+	reg.on_destroy<WorldBody>().connect<&PhysicsWorld::onWorldBodyDestroyed>(this);
+}
+
+void PhysicsWorld::disconnectScene()
+{
+	if (!m_Scene) return;
+
+	entt::registry& reg = m_Scene->GetRegistry();
+	reg.on_destroy<Collider>().disconnect<&PhysicsWorld::onColliderDestroyed>(this);
+	reg.on_destroy<RigidBody>().disconnect<&PhysicsWorld::onRigidBodyDestroyed>(this);
+	reg.on_destroy<WorldBody>().disconnect<&PhysicsWorld::onWorldBodyDestroyed>(this);
+
+	for (BodySlot& slot : m_worldBodies) {
+		if (slot.entity != entt::null && reg.valid(slot.entity)) {
+			reg.destroy(slot.entity);
+		}
+		slot.entity = entt::null;
+	}
+}
+
+void PhysicsWorld::onColliderDestroyed(entt::registry& reg, entt::entity entity)
+{
+	releaseProxy(reg.get<Collider>(entity));
+	m_modelMeshScales.erase(entity);
+}
+
+void PhysicsWorld::onRigidBodyDestroyed(entt::registry& reg, entt::entity entity)
+{
+	RigidBody& body = reg.get<RigidBody>(entity);
+	if (body.islandId != -1) {
+		m_islands.removeFromSleepingIsland(body.islandId, static_cast<uint32_t>(entity));
+		body.islandId = -1;
+	}
+
+	// A collider without a body is no longer simulated
+	if (Collider* col = reg.try_get<Collider>(entity)) {
+		releaseProxy(*col);
+	}
+}
+
+void PhysicsWorld::onWorldBodyDestroyed(entt::registry& reg, entt::entity entity)
+{
+	RigidBodyID id = reg.get<WorldBody>(entity).id;
+	if (BodySlot* slot = m_worldBodies.get(id)) {
+		// The entity is already going away, don't destroy it twice
+		slot->entity = entt::null;
+		destroyRigidBody(id);
+	}
+}
+
+void PhysicsWorld::releaseProxy(Collider& col)
+{
+	if (col.proxyId != -1) {
+		// Nothing else wakes bodies sleeping on static geometry that goes away
+		if (isStaticProxy(col.proxyId)) {
+			wakeBodiesIn(m_proxyBounds[col.proxyId]);
+		}
+		m_broadphase.destroyProxy(col.proxyId);
+		col.proxyId = -1;
+	}
+}
+
+void PhysicsWorld::wakeBodiesIn(const AABB& box)
+{
+	m_broadphase.getTree().query(box.expanded(kSpeculativeDistance), [&](int32_t proxyId) {
+		if (RigidBody* body = findBody(static_cast<entt::entity>(m_broadphase.getUserData(proxyId)))) {
+			wakeIsland(*body);
+		}
+		return true;
+		});
 }
 
 PhysicsWorld::~PhysicsWorld()
 {
+	// The scene may outlive us, its destroy signals must not call back in
+	setThreaded(false);
+	disconnectScene();
 }
 
-void PhysicsWorld::stepSimulation(float fixedDeltaTime)
+void PhysicsWorld::update(float frameDeltaTime)
+{
+	if (!m_Scene) return;
+
+	// The physics thread keeps its own clock, just show what it published
+	if (m_threaded) {
+		syncTransforms();
+		return;
+	}
+
+	m_accumulator += frameDeltaTime;
+
+	uint32_t substeps = 0;
+	while (m_accumulator >= m_fixedDeltaTime && substeps < m_maxSubsteps) {
+		stepSimulation(m_fixedDeltaTime);
+		m_accumulator -= m_fixedDeltaTime;
+		++substeps;
+	}
+
+	// Too far behind, drop the backlog instead of spiralling
+	if (m_accumulator >= m_fixedDeltaTime) {
+		m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+	}
+
+	m_interpolationAlpha = m_accumulator / m_fixedDeltaTime;
+	interpolateTransforms(m_interpolationAlpha);
+}
+
+void PhysicsWorld::setTickRate(float ticksPerSecond)
+{
+	if (ticksPerSecond > 0.0f) {
+		m_fixedDeltaTime = 1.0f / ticksPerSecond;
+	}
+}
+
+void PhysicsWorld::setMaxSubsteps(uint32_t maxSubsteps)
+{
+	m_maxSubsteps = std::max<uint32_t>(maxSubsteps, 1);
+}
+
+void PhysicsWorld::interpolateTransforms(float alpha)
 {
 	entt::registry& reg = m_Scene->GetRegistry();
-	reg.view<RigidBody, Transform>().each([&](entt::entity entity, RigidBody& body, Transform& transform) {
 
-		// Apply gravity if dynamic and enabled
-		if (!body.isKinematic && body.useGravity) {
-			body.velocity.y += gravity * fixedDeltaTime;
+	// Render between the last two fixed steps. syncedPosition follows so the
+	// next step doesn't mistake the blend for a teleport.
+	reg.view<RigidBody, Transform>().each([&](RigidBody& body, Transform& transform) {
+		transform.position = glm::mix(body.previousPosition, body.position, alpha);
+		body.syncedPosition = transform.position;
+		});
+}
+
+void PhysicsWorld::setThreaded(bool threaded)
+{
+	if (threaded == m_threaded) return;
+
+	if (threaded) {
+		if (!m_Scene) return;
+
+		m_accumulator = 0.0f;
+		m_renderedPositions.clear();
+		m_heldEntities.clear();
+		m_threaded = true;
+		m_threadRunning = true;
+		m_physicsThread = std::thread(&PhysicsWorld::physicsThreadLoop, this);
+	}
+	else {
+		m_threadRunning = false;
+		if (m_physicsThread.joinable()) {
+			m_physicsThread.join();
 		}
+		m_threaded = false;
 
-		// Update position
-		body.position += body.velocity * fixedDeltaTime;
+		// Hand Transform back to stepSimulation
+		std::lock_guard<std::mutex> lock(m_teleportMutex);
+		m_pendingTeleports.clear();
+		if (m_Scene) {
+			interpolateTransforms(1.0f);
+		}
+	}
+}
 
-		// Clamp Y so object doesn't fall below -5
-		if (body.position.y < -5.0f) {
-			body.position.y = -5.0f;
+void PhysicsWorld::physicsThreadLoop()
+{
+	using Clock = std::chrono::steady_clock;
+	auto nextTick = Clock::now();
 
-			// Optional: zero velocity when hitting the floor
-			if (body.velocity.y < 0.0f) {
-				body.velocity.y = 0.0f;
-			}
+	while (m_threadRunning) {
+		// Reloaded every tick so setTickRate() reaches a running thread
+		Clock::duration tick;
+		uint32_t maxSubsteps;
+		{
+			std::lock_guard<std::mutex> lock(m_sceneMutex);
+			stepSimulation(m_fixedDeltaTime);
+			publishSnapshot();
+			tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_fixedDeltaTime));
+			maxSubsteps = m_maxSubsteps;
 		}
 
-		// Kinematic movement logic (if any)
-		if (body.isKinematic) {
-			// body.position = yourManualMovementFunction(entity);
+		// Catch up at most m_maxSubsteps ticks, drop anything older
+		nextTick += tick;
+		auto now = Clock::now();
+		if (now > nextTick + tick * maxSubsteps) {
+			nextTick = now;
 		}
+		std::this_thread::sleep_until(nextTick);
+	}
+}
 
-		// Sync transform
-		transform.position = body.position;
+void PhysicsWorld::publishSnapshot()
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	TransformSnapshot& snapshot = m_snapshots.getWriteBuffer();
+	snapshot.entries.clear();
+
+	reg.view<RigidBody, Transform>().each([&](entt::entity entity, RigidBody& body, Transform&) {
+		snapshot.entries.push_back({ entity, body.previousPosition, body.position, body.rotation });
 		});
+	m_Scene->GetProjectiles().writeInstances(snapshot.projectiles);
+
+	snapshot.stepTime = std::chrono::steady_clock::now();
+	snapshot.teleportSequence = m_appliedTeleportSequence;
+	m_snapshots.publish();
+}
+
+void PhysicsWorld::syncTransforms()
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	m_snapshots.acquire();
+	const TransformSnapshot& snapshot = m_snapshots.getReadBuffer();
+
+	// The snapshot lags one tick behind, blend towards its latest state
+	float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.stepTime).count();
+	m_interpolationAlpha = std::clamp(elapsed / m_fixedDeltaTime, 0.0f, 1.0f);
+
+	m_previousRendered.swap(m_renderedPositions);
+	m_renderedPositions.clear();
+
+	for (const TransformSnapshot::Entry& entry : snapshot.entries) {
+		Transform* transform = reg.valid(entry.entity) ? reg.try_get<Transform>(entry.entity) : nullptr;
+		if (!transform) continue;
+
+		// Moved or turned by something other than us since last frame, forward it to the physics thread
+		auto rendered = m_previousRendered.find(entry.entity);
+		bool moved = rendered != m_previousRendered.end() && rendered->second != transform->position;
+		if ((moved || transform->rotation != entry.rotation) && !m_heldEntities.count(entry.entity)) {
+			std::lock_guard<std::mutex> lock(m_teleportMutex);
+			m_pendingTeleports.push_back({ entry.entity, transform->position, transform->rotation, ++m_teleportSequence });
+			m_heldEntities[entry.entity] = m_teleportSequence;
+		}
+
+		// Leave teleported entities alone until a snapshot includes the move
+		auto held = m_heldEntities.find(entry.entity);
+		if (held != m_heldEntities.end()) {
+			if (snapshot.teleportSequence < held->second) {
+				m_renderedPositions[entry.entity] = transform->position;
+				continue;
+			}
+			m_heldEntities.erase(held);
+		}
+
+		transform->position = glm::mix(entry.previous, entry.current, m_interpolationAlpha);
+		m_renderedPositions[entry.entity] = transform->position;
+	}
+
+	m_Scene->GetProjectiles().getRenderInstances() = snapshot.projectiles;
+}
+
+void PhysicsWorld::applyTeleports()
+{
+	entt::registry& reg = m_Scene->GetRegistry();
 
+	std::lock_guard<std::mutex> lock(m_teleportMutex);
+	for (const Teleport& teleport : m_pendingTeleports) {
+		RigidBody* body = reg.valid(teleport.entity) ? reg.try_get<RigidBody>(teleport.entity) : nullptr;
+		if (!body) continue;
+
+		body->position = teleport.position;
+		body->rotation = teleport.rotation;
+		body->previousPosition = teleport.position;
+		body->syncedPosition = teleport.position;
+		wakeIsland(*body);
+
+		// Static geometry is rebuilt at its new place, see updateBroadphase
+		Collider* col = reg.try_get<Collider>(teleport.entity);
+		if (body->isStatic && col) {
+			releaseProxy(*col);
+		}
+	}
+	if (!m_pendingTeleports.empty()) {
+		m_appliedTeleportSequence = m_pendingTeleports.back().sequence;
+	}
+	m_pendingTeleports.clear();
+}
+
+std::unique_lock<std::mutex> PhysicsWorld::lockScene()
+{
+	return std::unique_lock<std::mutex>(m_sceneMutex);
+}
+
+void PhysicsWorld::stepSimulation(float fixedDeltaTime)
+{
+#if PHYSICS_ENABLE_STATS
+	m_stats = PhysicsStats{ .stepCount = m_stats.stepCount + 1 };
+	size_t memoryBefore = getMemoryUsage();
+	{
+		PhysicsScopedTimer stepTimer(m_stats.stepMs);
+#endif
+
+	if (m_threaded) {
+		applyTeleports();
+	}
+	else {
+		pullTransforms();
+	}
+	m_contactEvents.clear();
+
+	// Gravity, 8 bodies per iteration
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Integrate);
+		gatherBodies();
+		m_bodyStore.integrateVelocities(fixedDeltaTime, gravity);
+	}
+
+	updateBroadphase(fixedDeltaTime);
 	detectCollision();
-	reg.view<Bullet, Transform>().each([&](entt::entity entity, Bullet& bullet, Transform& transform) {
-		if (bullet.active)
-		{
-			bullet.position += bullet.velocity * fixedDeltaTime;
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Events);
+		updateContactEvents();
+	}
 
-			transform.position = bullet.position;
+	// Contact impulses on the SoA velocities, then Euler step and floor or terrain clamp
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Solve);
+		m_solver.solve(m_contactCache.getManifolds(), m_bodyStore, fixedDeltaTime, m_taskPool);
+	}
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Integrate);
+		if (m_heightfield) {
+			m_bodyStore.integratePositions(fixedDeltaTime, -FLT_MAX);
+			clampToHeightfield();
+		}
+		else {
+			m_bodyStore.integratePositions(fixedDeltaTime, floorHeight);
 		}
+		scatterBodies();
+	}
+
+	updateIslands(fixedDeltaTime);
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Queries);
+		updateQueryBounds();
+		sweepBullets(fixedDeltaTime);
+	}
+	{
+		PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Events);
+		dispatchContactEvents();
+	}
 
+#if PHYSICS_ENABLE_STATS
+	}
+	collectStats(memoryBefore);
+#endif
+}
+
+void PhysicsWorld::gatherBodies()
+{
+	entt::registry& reg = m_Scene->GetRegistry();
 
+	// Registry bodies first, then the world's own, in a fixed order
+	m_simBodies.clear();
+	reg.view<RigidBody, Transform>().each([&](entt::entity entity, RigidBody& body, Transform& transform) {
+		m_simBodies.push_back({ entity, &body, reg.try_get<Collider>(entity), &transform });
 		});
+	for (BodySlot& slot : m_worldBodies) {
+		ColliderSlot* col = m_worldColliders.get(slot.collider);
+		m_simBodies.push_back({ slot.entity, &slot.body, col ? &col->collider : nullptr, nullptr });
+	}
+
+	// Awake bodies go into the SoA store
+	m_bodyStore.clear();
+	m_awakeBodies.clear();
+	for (size_t i = 0; i < m_simBodies.size(); ++i) {
+		RigidBody& body = *m_simBodies[i].body;
+		body.previousPosition = body.position;
+		if (body.isSleeping || body.isStatic) {
+			body.storeIndex = -1;
+			continue;
+		}
+		body.storeIndex = static_cast<int32_t>(m_bodyStore.add(body.position, body.velocity, body.mass, body.isKinematic, body.useGravity));
+		m_awakeBodies.push_back(static_cast<uint32_t>(i));
+	}
+}
+
+// Lifts awake bodies whose collider bottom sank into the terrain and drops
+// the velocity into the surface, the terrain version of the floor clamp
+void PhysicsWorld::clampToHeightfield()
+{
+	for (uint32_t simIndex : m_awakeBodies) {
+		const SimBody& sim = m_simBodies[simIndex];
+		const RigidBody& body = *sim.body;
+		if (body.isKinematic) continue;
+
+		// Box bottom relative to the center, taken from this step's placement
+		float bottom = 0.0f;
+		if (sim.collider && sim.collider->proxyId != -1) {
+			bottom = body.position.y - m_proxyBounds[sim.collider->proxyId].min.y;
+		}
 
+		size_t i = static_cast<size_t>(body.storeIndex);
+		float height;
+		glm::vec3 normal;
+		m_heightfield->sample(m_bodyStore.px[i], m_bodyStore.pz[i], height, normal);
 
+		float depth = height - (m_bodyStore.py[i] - bottom);
+		if (depth <= 0.0f) continue;
+		m_bodyStore.py[i] += depth;
 
+		glm::vec3 velocity = m_bodyStore.getVelocity(i);
+		float intoSurface = glm::dot(velocity, normal);
+		if (intoSurface < 0.0f) {
+			velocity -= intoSurface * normal;
+			m_bodyStore.vx[i] = velocity.x;
+			m_bodyStore.vy[i] = velocity.y;
+			m_bodyStore.vz[i] = velocity.z;
+		}
+	}
+}
+
+void PhysicsWorld::scatterBodies()
+{
+	for (const SimBody& sim : m_simBodies) {
+		RigidBody& body = *sim.body;
+		if (body.storeIndex < 0) continue;
+
+		body.position = m_bodyStore.getPosition(body.storeIndex);
+		body.velocity = m_bodyStore.getVelocity(body.storeIndex);
+
+		// The physics thread leaves Transform to the main thread's snapshot sync
+		if (!m_threaded && sim.transform) {
+			sim.transform->position = body.position;
+			body.syncedPosition = body.position;
+		}
+	}
+}
+
+#if PHYSICS_ENABLE_STATS
+void PhysicsWorld::collectStats(size_t memoryBefore)
+{
+	m_stats.bodies = static_cast<uint32_t>(m_simBodies.size());
+	m_stats.awakeBodies = static_cast<uint32_t>(m_awakeBodies.size());
+	m_stats.proxies = static_cast<uint32_t>(m_broadphase.getProxyCount());
+	m_stats.cells = static_cast<uint32_t>(m_broadphase.getCellCount());
+	m_stats.candidatePairs = static_cast<uint32_t>(m_broadphase.getPairs().size());
+	m_stats.contacts = static_cast<uint32_t>(m_contactCache.getManifolds().size());
+	m_stats.triggerContacts = static_cast<uint32_t>(m_triggerContacts.size());
+	m_stats.solverIslands = m_solver.getIslandCount();
+	m_stats.solverColors = m_solver.getColorCount();
+	m_stats.events = static_cast<uint32_t>(m_contactEvents.size());
+	m_stats.memoryBytes = getMemoryUsage();
+	m_stats.allocatedBytes = m_stats.memoryBytes > memoryBefore ? m_stats.memoryBytes - memoryBefore : 0;
 }
+#endif
 
 
 
-RigidBody PhysicsWorld::createRigidBody(const RigidBodyDesc& desc)
+RigidBodyID PhysicsWorld::createRigidBody(const RigidBodyDesc& desc)
 {
-	return RigidBody(desc);
+	RigidBodyID id = m_worldBodies.emplace(BodySlot{ RigidBody(desc) });
+	if (id == kInvalidHandle) return id;
+
+	// Without a scene the entity is created once one is set
+	if (m_Scene) {
+		entt::registry& reg = m_Scene->GetRegistry();
+		BodySlot& slot = *m_worldBodies.get(id);
+		slot.entity = reg.create();
+		reg.emplace<WorldBody>(slot.entity, id);
+	}
+	return id;
 }
 
 void PhysicsWorld::destroyRigidBody(RigidBodyID id)
 {
+	BodySlot* slot = m_worldBodies.get(id);
+	if (!slot) return;
+
+	if (slot->collider != kInvalidHandle) {
+		detachCollider(id, slot->collider);
+	}
+	if (slot->body.islandId != -1) {
+		m_islands.removeFromSleepingIsland(slot->body.islandId, static_cast<uint32_t>(slot->entity));
+	}
+
+	entt::entity entity = slot->entity;
+	m_worldBodies.erase(id);
+
+	// Erased first so the destroy hook finds nothing left to do
+	if (entity != entt::null && m_Scene) {
+		entt::registry& reg = m_Scene->GetRegistry();
+		if (reg.valid(entity)) {
+			reg.destroy(entity);
+		}
+	}
 }
 
 RigidBody* PhysicsWorld::getRigidBody(RigidBodyID id)
 {
-	return nullptr;
+	BodySlot* slot = m_worldBodies.get(id);
+	return slot ? &slot->body : nullptr;
 }
 
-Collider PhysicsWorld::createCollider(const ColliderDesc& desc)
+entt::entity PhysicsWorld::getEntity(RigidBodyID id) const
 {
-	return Collider(desc);
+	const BodySlot* slot = m_worldBodies.get(id);
+	return slot ? slot->entity : entt::entity(entt::null);
+}
+
+ColliderID PhysicsWorld::createCollider(const ColliderDesc& desc)
+{
+	return m_worldColliders.emplace(ColliderSlot{ Collider(desc) });
+}
+
+void PhysicsWorld::destroyCollider(ColliderID id)
+{
+	ColliderSlot* slot = m_worldColliders.get(id);
+	if (!slot) return;
+
+	if (slot->body != kInvalidHandle) {
+		detachCollider(slot->body, id);
+	}
+	m_worldColliders.erase(id);
+}
+
+Collider* PhysicsWorld::getCollider(ColliderID id)
+{
+	ColliderSlot* slot = m_worldColliders.get(id);
+	return slot ? &slot->collider : nullptr;
 }
 
 void PhysicsWorld::attachCollider(RigidBodyID body, ColliderID collider)
 {
+	BodySlot* bodySlot = m_worldBodies.get(body);
+	ColliderSlot* colliderSlot = m_worldColliders.get(collider);
+	if (!bodySlot || !colliderSlot || bodySlot->collider == collider) return;
+
+	if (bodySlot->collider != kInvalidHandle) {
+		detachCollider(body, bodySlot->collider);
+	}
+	if (colliderSlot->body != kInvalidHandle) {
+		detachCollider(colliderSlot->body, collider);
+	}
+
+	// The proxy is created on the next step
+	bodySlot->collider = collider;
+	colliderSlot->body = body;
+	wakeIsland(bodySlot->body);
 }
 
 void PhysicsWorld::detachCollider(RigidBodyID body, ColliderID collider)
 {
+	BodySlot* bodySlot = m_worldBodies.get(body);
+	ColliderSlot* colliderSlot = m_worldColliders.get(collider);
+	if (!bodySlot || !colliderSlot || bodySlot->collider != collider) return;
+
+	releaseProxy(colliderSlot->collider);
+	bodySlot->collider = kInvalidHandle;
+	colliderSlot->body = kInvalidHandle;
+	wakeIsland(bodySlot->body);
 }
 
-//bool PhysicsWorld::raycast(const Ray& ray, RaycastHit& hit)
-//{
-//	return false;
-//}
-//
-//void PhysicsWorld::overlapQuery(const Shape& shape, const Transform& pose, std::vector<BodyID>& results)
-//{
-//}
+bool PhysicsWorld::raycast(const Ray& ray, RaycastHit& hit)
+{
+	hit = RaycastHit();
+
+	auto test = [&](int32_t proxyId, float maxDistance) {
+		float distance;
+		glm::vec3 normal;
+		if (!intersectRayShape(ray, m_proxyShapes[proxyId], m_proxyBounds[proxyId], maxDistance, distance, normal)) {
+			return maxDistance;
+		}
+
+		hit.body = static_cast<entt::entity>(m_broadphase.getUserData(proxyId));
+		hit.distance = distance;
+		hit.point = ray.origin + ray.direction * distance;
+		hit.normal = normal;
+		return distance;
+		};
+
+	// The static tree only has to beat the closest dynamic hit
+	m_broadphase.getTree().rayCast(ray.origin, ray.direction, ray.maxDistance, test);
+	m_broadphase.getStaticTree().rayCast(ray.origin, ray.direction, hit.hasHit() ? hit.distance : ray.maxDistance,
+		[&](int32_t index, float maxDistance) { return test(index | kStaticProxyBit, maxDistance); });
+
+	return hit.hasHit();
+}
+
+void PhysicsWorld::raycastBatch(const Ray* rays, size_t count, RaycastHit* hits)
+{
+	size_t packets = (count + kRayPacketSize - 1) / kRayPacketSize;
+
+	m_taskPool.parallelFor(packets, kRayPacketChunkSize, [&](size_t begin, size_t end, size_t) {
+		for (size_t packet = begin; packet < end; ++packet) {
+			size_t first = packet * kRayPacketSize;
+			raycastPacket(m_broadphase.getTree(), m_proxyBounds.dynamicEntries, m_proxyShapes.dynamicEntries,
+				m_broadphase.getStaticTree(), m_proxyBounds.staticEntries, m_proxyShapes.staticEntries,
+				rays + first, std::min(kRayPacketSize, count - first), hits + first);
+		}
+		});
+}
+
+void PhysicsWorld::overlapQuery(const ColliderDesc& shape, const Transform& pose, std::vector<entt::entity>& results)
+{
+	results.clear();
+
+	ShapeInstance query = ShapeInstance::fromCollider(Collider(shape), pose.position, pose.rotation);
+	AABB box = query.computeAABB();
+
+	auto test = [&](int32_t proxyId) {
+		ContactManifold contact;
+		if (m_proxyBounds[proxyId].overlaps(box) && collideShapes(query, m_proxyShapes[proxyId], 0.0f, contact)) {
+			results.push_back(static_cast<entt::entity>(m_broadphase.getUserData(proxyId)));
+		}
+		return true;
+		};
+
+	m_broadphase.getTree().query(box, test);
+	m_broadphase.getStaticTree().query(box, [&](int32_t index) { return test(index | kStaticProxyBit); });
+}
+
+CharacterMoveResult PhysicsWorld::moveCharacter(const CharacterDesc& desc, const glm::vec3& position, const glm::vec3& displacement)
+{
+	CharacterMoveResult result;
+	result.position = position;
+
+	ShapeInstance capsule;
+	capsule.type = ColliderType::Capsule;
+	capsule.radius = desc.radius;
+	capsule.halfHeight = desc.halfHeight;
+
+	glm::vec3 remaining = displacement;
+	for (uint32_t slide = 0; slide < kMaxCharacterSlides; ++slide) {
+		float length = glm::length(remaining);
+		if (length <= 1e-5f) break;
+		glm::vec3 direction = remaining / length;
+
+		// Everything the capsule could touch on the way
+		capsule.center = result.position;
+		AABB start = capsule.computeAABB();
+		capsule.center = result.position + remaining;
+		gatherCharacterCandidates(AABB::merge(start, capsule.computeAABB()).expanded(desc.skinWidth), desc);
+
+		// Conservative advancement, the capsule only translates so it can
+		// always move as far as the closest surface ahead of it
+		float travelled = 0.0f;
+		bool blocked = false;
+		ContactManifold contact;
+		for (uint32_t step = 0; step < kMaxCharacterAdvances; ++step) {
+			capsule.center = result.position + direction * travelled;
+			if (!findCharacterContact(capsule, direction, length - travelled + desc.skinWidth, contact)) {
+				travelled = length;
+				break;
+			}
+			if (contact.separation <= desc.skinWidth) {
+				blocked = true;
+				break;
+			}
+			travelled = std::min(travelled + contact.separation - desc.skinWidth, length);
+		}
+		result.position += direction * travelled;
+		if (!blocked) break;
+
+		// Slide, drop the part of the move that goes into the surface
+		glm::vec3 normal = -contact.normal;
+		++result.hits;
+		if (normal.y >= desc.maxSlopeCos) {
+			result.isGrounded = true;
+			result.groundNormal = normal;
+		}
+		else if (normal.y <= -desc.maxSlopeCos) {
+			result.hitCeiling = true;
+		}
+		remaining = direction * (length - travelled);
+		remaining -= normal * std::min(glm::dot(remaining, normal), 0.0f);
+	}
+
+	// Bodies that moved into the capsule, or a spawn inside something
+	capsule.center = result.position;
+	gatherCharacterCandidates(capsule.computeAABB(), desc);
+	for (int32_t proxyId : m_characterCandidates) {
+		ContactManifold contact;
+		capsule.center = result.position;
+		if (!collideShapes(capsule, m_proxyShapes[proxyId], 0.0f, contact) || contact.separation >= 0.0f) continue;
+
+		result.position += contact.normal * contact.separation;
+		if (-contact.normal.y >= desc.maxSlopeCos) {
+			result.isGrounded = true;
+			result.groundNormal = -contact.normal;
+		}
+	}
+
+	// Terrain and floor aren't proxies, stand on them directly
+	float bottom = result.position.y - desc.halfHeight - desc.radius;
+	float ground = floorHeight;
+	glm::vec3 groundNormal(0.0f, 1.0f, 0.0f);
+	if (m_heightfield) {
+		m_heightfield->sample(result.position.x, result.position.z, ground, groundNormal);
+	}
+	if (bottom <= ground + desc.skinWidth) {
+		result.position.y = std::max(result.position.y, ground + desc.halfHeight + desc.radius);
+		result.isGrounded = true;
+		result.groundNormal = groundNormal;
+	}
+
+	return result;
+}
+
+void PhysicsWorld::gatherCharacterCandidates(const AABB& box, const CharacterDesc& desc)
+{
+	m_characterCandidates.clear();
+
+	auto collect = [&](int32_t proxyId) {
+		if (shouldCollide(desc.layer, desc.mask, m_broadphase.getLayer(proxyId), m_broadphase.getMask(proxyId))
+			&& m_proxyBounds[proxyId].overlaps(box)) {
+			m_characterCandidates.push_back(proxyId);
+		}
+		return true;
+		};
+
+	m_broadphase.getTree().query(box, collect);
+	m_broadphase.getStaticTree().query(box, [&](int32_t index) { return collect(index | kStaticProxyBit); });
+}
+
+bool PhysicsWorld::findCharacterContact(const ShapeInstance& capsule, const glm::vec3& direction, float maxSeparation, ContactManifold& contact) const
+{
+	// Closest surface the move heads into, ones it leaves can't block it
+	bool found = false;
+	for (int32_t proxyId : m_characterCandidates) {
+		ContactManifold candidate;
+		if (!collideShapes(capsule, m_proxyShapes[proxyId], maxSeparation, candidate)) continue;
+		if (glm::dot(candidate.normal, direction) <= 0.0f) continue;
+
+		if (!found || candidate.separation < contact.separation) {
+			contact = candidate;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void PhysicsWorld::updateCharacters(float deltaTime)
+{
+	if (!m_Scene || deltaTime <= 0.0f) return;
+
+	entt::registry& reg = m_Scene->GetRegistry();
+	reg.view<PlayerController, Transform>().each([&](PlayerController& player, Transform& transform) {
+		CharacterDesc desc;
+		desc.radius = std::max(player.halfExtents.x, player.halfExtents.z);
+		desc.halfHeight = std::max(player.halfExtents.y - desc.radius, 0.0f);
+
+		if (player.jumpRequested && player.isGrounded) {
+			player.velocity.y = player.jumpForce;
+		}
+		player.jumpRequested = false;
+
+		player.velocity.x = player.moveInput.x * player.moveSpeed;
+		player.velocity.z = player.moveInput.z * player.moveSpeed;
+		player.velocity.y += gravity * deltaTime;
+
+		CharacterMoveResult result = moveCharacter(desc, transform.position, player.velocity * deltaTime);
+
+		// Landing or hitting the ceiling ends the vertical motion
+		if ((result.isGrounded && player.velocity.y < 0.0f) || (result.hitCeiling && player.velocity.y > 0.0f)) {
+			player.velocity.y = 0.0f;
+		}
+		transform.position = result.position;
+		player.isGrounded = result.isGrounded;
+		});
+}
+
+void PhysicsWorld::captureSnapshot(Snapshot& snapshot) const
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	// Same order as gatherBodies, registry bodies first
+	snapshot.bodies.clear();
+	reg.view<RigidBody>().each([&](entt::entity entity, const RigidBody& body) {
+		snapshot.bodies.push_back({ entity, body });
+		});
+	for (const BodySlot& slot : m_worldBodies) {
+		snapshot.bodies.push_back({ slot.entity, slot.body });
+	}
+
+	snapshot.manifolds = m_contactCache.getManifolds();
+	snapshot.touching = m_touching;
+	m_islands.saveSleepingIslands(snapshot.islandOffsets, snapshot.islandMembers, snapshot.freeIslands);
+	m_Scene->GetProjectiles().save(snapshot.projectiles);
+}
+
+void PhysicsWorld::restoreSnapshot(const Snapshot& snapshot)
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	// Moves queued before the restore belong to the discarded timeline
+	{
+		std::lock_guard<std::mutex> lock(m_teleportMutex);
+		m_pendingTeleports.clear();
+	}
+	m_heldEntities.clear();
+
+	// Bodies created after the capture are in none of the restored islands.
+	// Captured bodies get their saved state back below.
+	auto wake = [](RigidBody& body) {
+		body.isSleeping = false;
+		body.sleepTimer = 0.0f;
+		body.islandId = -1;
+		};
+	reg.view<RigidBody>().each([&](RigidBody& body) { wake(body); });
+	for (BodySlot& slot : m_worldBodies) {
+		wake(slot.body);
+	}
+
+	for (const Snapshot::Body& saved : snapshot.bodies) {
+		RigidBody* body = findBody(saved.entity);
+		if (!body) continue;
+
+		bool staticMoved = body->isStatic && body->position != saved.body.position;
+		*body = saved.body;
+		body->syncedPosition = body->position;
+
+		if (Transform* transform = reg.try_get<Transform>(saved.entity)) {
+			transform->position = body->position;
+			transform->rotation = body->rotation;
+			if (m_threaded) {
+				m_renderedPositions[saved.entity] = body->position;
+			}
+		}
+
+		// Proxies follow, the pair set catches up on the next updatePairs()
+		Collider* col = findCollider(saved.entity);
+		if (!col || col->proxyId == -1) continue;
+		if (body->isStatic) {
+			if (staticMoved) {
+				releaseProxy(*col);
+			}
+			continue;
+		}
+		placeShape(col->proxyId, *body, *col);
+		m_broadphase.moveProxy(col->proxyId, m_proxyBounds[col->proxyId], glm::vec3(0.0f));
+	}
+
+	// Contacts of bodies destroyed since the capture have nothing to act on
+	auto destroyed = [&](uint32_t id) {
+		return id != kGroundId && !reg.valid(static_cast<entt::entity>(id));
+		};
+	std::vector<ContactManifold>& manifolds = m_contactCache.getManifolds();
+	manifolds = snapshot.manifolds;
+	std::erase_if(manifolds, [&](const ContactManifold& m) { return destroyed(m.entityA) || destroyed(m.entityB); });
+	m_touching = snapshot.touching;
+	std::erase_if(m_touching, [&](const TouchingPair& pair) { return destroyed(pair.entityA) || destroyed(pair.entityB); });
+	m_islands.loadSleepingIslands(snapshot.islandOffsets, snapshot.islandMembers, snapshot.freeIslands);
+	m_Scene->GetProjectiles().load(snapshot.projectiles);
+}
 
 void PhysicsWorld::setCollisionCallback(CollisionCallback cb)
 {
+	m_collisionCallback = std::move(cb);
 }
 
 void PhysicsWorld::setTriggerCallback(TriggerCallback cb)
 {
+	m_triggerCallback = std::move(cb);
 }
-void PhysicsWorld::detectCollision()
+
+void PhysicsWorld::setContactEventCallback(ContactEventCallback cb)
 {
-    entt::registry& reg = m_Scene->GetRegistry();
+	m_contactEventCallback = std::move(cb);
+}
+void PhysicsWorld::updateQueryBounds()
+{
+	// Fat AABBs only bound the tree, queries answer against the real shapes
+	for (const SimBody& sim : m_simBodies) {
+		if (!sim.collider || sim.collider->proxyId == -1) continue;
+		placeShape(sim.collider->proxyId, *sim.body, *sim.collider);
+	}
+}
 
-    // Spatial hash grid structure
-    struct GridCell {
-        std::vector<entt::entity> entities;
-    };
-
-    // Use a better cell size based on your game scale
-    float cellSize = 2.0f;
-
-    // Create spatial hash grid - using unordered_map for sparse grids
-    std::unordered_map<uint64_t, GridCell> grid;
-
-    // Hash function to convert grid coordinates to key
-    auto cellKey = [](int x, int y, int z) -> uint64_t {
-        // Use bit mixing for better distribution
-        uint64_t h1 = std::hash<int>{}(x);
-        uint64_t h2 = std::hash<int>{}(y);
-        uint64_t h3 = std::hash<int>{}(z);
-        return h1 ^ (h2 << 1) ^ (h3 << 2);
-        };
-
-    // Phase 1: Broad phase - build spatial grid
-    auto view = reg.view<RigidBody, Collider, Transform>();
-
-    // Reserve space if you know approximate count
-    // grid.reserve(view.size_hint() * 8); // Estimate 8 cells per entity
-
-    view.each([&](entt::entity entity, RigidBody& body, Collider& col, Transform& trans) {
-        glm::vec3 halfExtents = col.size * 0.5f;
-        glm::vec3 min = trans.position - halfExtents;
-        glm::vec3 max = trans.position + halfExtents;
-
-        // Calculate grid cells that this AABB touches
-        int minX = static_cast<int>(std::floor(min.x / cellSize));
-        int maxX = static_cast<int>(std::floor(max.x / cellSize));
-        int minY = static_cast<int>(std::floor(min.y / cellSize));
-        int maxY = static_cast<int>(std::floor(max.y / cellSize));
-        int minZ = static_cast<int>(std::floor(min.z / cellSize));
-        int maxZ = static_cast<int>(std::floor(max.z / cellSize));
-
-        // Add entity to all overlapping cells
-        for (int x = minX; x <= maxX; ++x) {
-            for (int y = minY; y <= maxY; ++y) {
-                for (int z = minZ; z <= maxZ; ++z) {
-                    uint64_t key = cellKey(x, y, z);
-                    grid[key].entities.push_back(entity);
-                }
-            }
-        }
-        });
+void PhysicsWorld::placeShape(int32_t proxyId, const RigidBody& body, const Collider& col)
+{
+	m_proxyShapes.reserveEntry(proxyId);
+	m_proxyBounds.reserveEntry(proxyId);
 
-    // Track which pairs we've already processed to avoid duplicates
-    std::unordered_set<uint64_t> processedPairs;
+	m_proxyShapes[proxyId] = ShapeInstance::fromCollider(col, body.position, body.rotation);
+	m_proxyBounds[proxyId] = m_proxyShapes[proxyId].computeAABB();
+}
 
-    // Phase 2: Narrow phase - check collisions within each cell
-    for (auto& [cellKey, cell] : grid) {
-        auto& entities = cell.entities;
-        size_t count = entities.size();
+void PhysicsWorld::sweepBullets(float fixedDeltaTime)
+{
+	ProjectilePool& pool = m_Scene->GetProjectiles();
 
-        // Skip cells with 0 or 1 entities
-        if (count < 2) continue;
+	// Each projectile sweeps its own path through both trees, the rest of the world is stepped once
+	size_t i = 0;
+	while (i < pool.size()) {
+		pool.lifetime[i] -= fixedDeltaTime;
+		if (pool.lifetime[i] <= 0.0f) {
+			pool.release(i);
+			continue;
+		}
 
-        // Check all unique pairs in this cell
-        for (size_t i = 0; i < count; ++i) {
-            entt::entity entityA = entities[i];
+		glm::vec3 position(pool.px[i], pool.py[i], pool.pz[i]);
+		glm::vec3 displacement = glm::vec3(pool.vx[i], pool.vy[i], pool.vz[i]) * fixedDeltaTime;
+		float length = glm::length(displacement);
+		float radius = pool.radius[i];
+		bool hit = false;
+		if (length > 0.0f) {
+			Ray ray;
+			ray.origin = position;
+			ray.direction = displacement / length;
 
-            for (size_t j = i + 1; j < count; ++j) {
-                entt::entity entityB = entities[j];
+			int32_t hitProxy = kNullNode;
+			float hitDistance = length;
+			auto test = [&](int32_t proxyId, float maxDistance) {
+				if (!shouldCollide(pool.layer[i], pool.mask[i], m_broadphase.getLayer(proxyId), m_broadphase.getMask(proxyId))) {
+					return maxDistance;
+				}
 
-                // Create unique pair ID (ordered to avoid duplicates)
-                entt::entity smaller = entityA < entityB ? entityA : entityB;
-                entt::entity larger = entityA < entityB ? entityB : entityA;
+				float distance;
+				glm::vec3 normal;
+				// Meshes are traced with the bare ray, their triangles are large next to a bullet
+				if (!intersectRayShape(ray, m_proxyShapes[proxyId], m_proxyBounds[proxyId].expanded(radius), maxDistance, distance, normal,
+					radius)) {
+					return maxDistance;
+				}
 
-                uint64_t pairId = (static_cast<uint64_t>(smaller) << 32) | static_cast<uint64_t>(larger);
+				hitProxy = proxyId;
+				hitDistance = distance;
+				return distance;
+				};
 
-                // Skip if we've already processed this pair
-                if (processedPairs.find(pairId) != processedPairs.end()) {
-                    continue;
-                }
+			m_broadphase.getTree().rayCast(ray.origin, ray.direction, length, test, radius);
+			m_broadphase.getStaticTree().rayCast(ray.origin, ray.direction, hitDistance,
+				[&](int32_t index, float maxDistance) { return test(index | kStaticProxyBit, maxDistance); }, radius);
 
-                processedPairs.insert(pairId);
+			if (hitProxy != kNullNode) {
+				// Stop at first contact, the slot goes back to the pool
+				ContactEvent event;
+				event.isProjectile = true;
+				event.entityA = pool.owner[i];
+				event.entityB = static_cast<entt::entity>(m_broadphase.getUserData(hitProxy));
+				event.normal = ray.direction;
+				event.toi = hitDistance / length;
+				m_contactEvents.push_back(event);
+				hit = true;
+			}
+			else {
+				position += displacement;
+			}
+		}
 
-                // Get components
-                auto [bodyA, colA, transA] = reg.get<RigidBody, Collider, Transform>(entityA);
-                auto [bodyB, colB, transB] = reg.get<RigidBody, Collider, Transform>(entityB);
+		if (hit) {
+			pool.release(i);
+			continue;
+		}
+		pool.px[i] = position.x;
+		pool.py[i] = position.y;
+		pool.pz[i] = position.z;
+		++i;
+	}
 
-                // Fast AABB overlap test
-                glm::vec3 halfA = colA.size * 0.5f;
-                glm::vec3 halfB = colB.size * 0.5f;
+	if (!m_threaded) {
+		pool.writeInstances(pool.getRenderInstances());
+	}
+}
 
-                glm::vec3 minA = transA.position - halfA;
-                glm::vec3 maxA = transA.position + halfA;
-                glm::vec3 minB = transB.position - halfB;
-                glm::vec3 maxB = transB.position + halfB;
+void PhysicsWorld::updateContactEvents()
+{
+	m_touching.swap(m_previousTouching);
+	m_touching.clear();
 
-                // Early out if no overlap
-                if (maxA.x < minB.x || minA.x > maxB.x ||
-                    maxA.y < minB.y || minA.y > maxB.y ||
-                    maxA.z < minB.z || minA.z > maxB.z) {
-                    continue;
-                }
+	auto wasTouching = [&](uint64_t pairId) {
+		auto it = std::lower_bound(m_previousTouching.begin(), m_previousTouching.end(), pairId,
+			[](const TouchingPair& pair, uint64_t id) { return pair.pairId < id; });
+		return it != m_previousTouching.end() && it->pairId == pairId;
+		};
 
-                // Detailed collision resolution
-                resolveCollision(bodyA, colA, transA, bodyB, colB, transB);
-            }
+	// Sleeping pairs keep their cached state, speculative contacts don't count
+	for (const ContactManifold& m : m_contactCache.getManifolds()) {
+		if (m.separation < kTouchingDistance) {
+			m_touching.push_back({ m.pairId, m.entityA, m.entityB, m.normal, false, m.asleep });
+		}
+	}
+	for (const ContactManifold& m : m_triggerContacts) {
+		if (m.asleep ? wasTouching(m.pairId) : m.separation <= 0.0f) {
+			m_touching.push_back({ m.pairId, m.entityA, m.entityB, m.normal, true, m.asleep });
+		}
+	}
+	std::sort(m_touching.begin(), m_touching.end(), [](const TouchingPair& a, const TouchingPair& b) {
+		return a.pairId < b.pairId;
+		});
+
+	auto toEntity = [](uint32_t id) {
+		return id == kGroundId ? entt::entity(entt::null) : static_cast<entt::entity>(id);
+		};
+	auto emit = [&](ContactEventType type, const TouchingPair& pair) {
+		ContactEvent event;
+		event.type = type;
+		event.isTrigger = pair.isTrigger;
+		event.entityA = toEntity(pair.entityA);
+		event.entityB = toEntity(pair.entityB);
+		event.normal = type == ContactEventType::End ? glm::vec3(0.0f) : pair.normal;
+		m_contactEvents.push_back(event);
+		};
+
+	// Walk both sorted sets, a recycled proxy id shows up as end + begin
+	size_t previous = 0;
+	size_t current = 0;
+	while (previous < m_previousTouching.size() || current < m_touching.size()) {
+		if (current == m_touching.size() ||
+			(previous < m_previousTouching.size() && m_previousTouching[previous].pairId < m_touching[current].pairId)) {
+			emit(ContactEventType::End, m_previousTouching[previous++]);
+		}
+		else if (previous == m_previousTouching.size() || m_touching[current].pairId < m_previousTouching[previous].pairId) {
+			emit(ContactEventType::Begin, m_touching[current++]);
+		}
+		else {
+			const TouchingPair& before = m_previousTouching[previous++];
+			const TouchingPair& now = m_touching[current++];
+			if (before.entityA != now.entityA || before.entityB != now.entityB) {
+				emit(ContactEventType::End, before);
+				emit(ContactEventType::Begin, now);
+			}
+			else if (!now.asleep) {
+				emit(ContactEventType::Stay, now);
+			}
+		}
+	}
+}
+
+void PhysicsWorld::dispatchContactEvents()
+{
+	// Callbacks may touch the registry, so they only run once the step is done
+	if (m_contactEventCallback && !m_contactEvents.empty()) {
+		m_contactEventCallback(m_contactEvents);
+	}
+
+	if (!m_collisionCallback && !m_triggerCallback) return;
+
+	for (const ContactEvent& event : m_contactEvents) {
+		if (event.type != ContactEventType::Begin) continue;
+
+		if (event.isTrigger) {
+			if (m_triggerCallback) {
+				m_triggerCallback(event.entityB, event.entityA);
+			}
+		}
+		else if (m_collisionCallback) {
+			m_collisionCallback(event.entityA, event.entityB, event.toi);
+		}
+	}
+}
+
+void PhysicsWorld::pullTransforms()
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+
+	// Scripts and gizmos write Transform directly, treat that as a teleport
+	reg.view<RigidBody, Transform>().each([&](entt::entity entity, RigidBody& body, Transform& transform) {
+		if (transform.position != body.syncedPosition || transform.rotation != body.rotation) {
+			body.position = transform.position;
+			body.rotation = transform.rotation;
+			body.syncedPosition = transform.position;
+			wakeIsland(body);
+
+			Collider* col = reg.try_get<Collider>(entity);
+			if (body.isStatic && col) {
+				releaseProxy(*col);
+			}
+		}
+		else if (body.isSleeping && body.velocity != glm::vec3(0.0f)) {
+			wakeIsland(body);
+		}
+		});
+}
+
+void PhysicsWorld::wakeIsland(RigidBody& body)
+{
+	if (!body.isSleeping) return;
+
+	body.isSleeping = false;
+	body.sleepTimer = 0.0f;
+
+	int32_t islandId = body.islandId;
+	body.islandId = -1;
+	if (islandId == -1) return;
+
+	for (uint32_t member : m_islands.getSleepingIsland(islandId)) {
+		RigidBody* other = findBody(static_cast<entt::entity>(member));
+		if (other && other->islandId == islandId) {
+			other->isSleeping = false;
+			other->sleepTimer = 0.0f;
+			other->islandId = -1;
+		}
+	}
+	m_islands.releaseSleepingIsland(islandId);
+}
+
+RigidBody* PhysicsWorld::findBody(entt::entity entity)
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+	if (!reg.valid(entity)) return nullptr;
+
+	if (RigidBody* body = reg.try_get<RigidBody>(entity)) {
+		return body;
+	}
+	if (WorldBody* owned = reg.try_get<WorldBody>(entity)) {
+		return getRigidBody(owned->id);
+	}
+	return nullptr;
+}
+
+Collider* PhysicsWorld::findCollider(entt::entity entity)
+{
+	entt::registry& reg = m_Scene->GetRegistry();
+	if (!reg.valid(entity)) return nullptr;
+
+	if (Collider* col = reg.try_get<Collider>(entity)) {
+		return col;
+	}
+	if (WorldBody* owned = reg.try_get<WorldBody>(entity)) {
+		BodySlot* slot = m_worldBodies.get(owned->id);
+		ColliderSlot* col = slot ? m_worldColliders.get(slot->collider) : nullptr;
+		return col ? &col->collider : nullptr;
+	}
+	return nullptr;
+}
+
+void PhysicsWorld::updateIslands(float fixedDeltaTime)
+{
+	PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Islands);
+
+	// Contacts between awake dynamic bodies connect islands
+	m_islands.begin(m_awakeBodies.size());
+	for (const auto& [indexA, indexB] : m_islandLinks) {
+		m_islands.link(indexA, indexB);
+	}
+
+	// An island can sleep once its most restless body has been still long enough
+	m_islandSleepTime.assign(m_awakeBodies.size(), FLT_MAX);
+	for (size_t i = 0; i < m_awakeBodies.size(); ++i) {
+		RigidBody& body = *m_simBodies[m_awakeBodies[i]].body;
+
+		if (body.isKinematic || !m_allowSleeping ||
+			glm::dot(body.velocity, body.velocity) > kLinearSleepTolerance * kLinearSleepTolerance) {
+			body.sleepTimer = 0.0f;
+		}
+		else {
+			body.sleepTimer += fixedDeltaTime;
+		}
+
+		int32_t root = m_islands.find(static_cast<int32_t>(i));
+		m_islandSleepTime[root] = std::min(m_islandSleepTime[root], body.sleepTimer);
+	}
+
+	// Put settled islands to sleep, remembering their members for waking
+	m_rootIsland.assign(m_awakeBodies.size(), -1);
+	for (size_t i = 0; i < m_awakeBodies.size(); ++i) {
+		int32_t root = m_islands.find(static_cast<int32_t>(i));
+		if (m_islandSleepTime[root] < kTimeToSleep) continue;
+
+		// Woken this step but not simulated yet
+		const SimBody& sim = m_simBodies[m_awakeBodies[i]];
+		RigidBody& body = *sim.body;
+		if (body.isSleeping || body.storeIndex < 0) continue;
+
+		if (m_rootIsland[root] == -1) {
+			m_rootIsland[root] = m_islands.createSleepingIsland();
+		}
+
+		body.isSleeping = true;
+		body.velocity = glm::vec3(0.0f);
+		body.islandId = m_rootIsland[root];
+		m_islands.addToSleepingIsland(body.islandId, static_cast<uint32_t>(sim.entity));
+	}
+}
+
+// Mesh colliders left empty on a model get their triangles once the model
+// has loaded. The scale is baked into the vertices, so a scale change starts
+// a new build. The old mesh is dropped right away and the collider sits out
+// until the new one is ready, like after the first build.
+void PhysicsWorld::buildModelMeshes()
+{
+    entt::registry& reg = m_Scene->GetRegistry();
+    reg.view<Collider, ModelComponent, Transform>().each([&](entt::entity entity, Collider& col, ModelComponent& component, Transform& transform) {
+        if (col.type != ColliderType::Mesh || !component.model || !component.model->IsLoaded()) return;
+
+        if (col.mesh.valid()) {
+            // Meshes the user supplied are in body space and never rebuilt
+            auto built = m_modelMeshScales.find(entity);
+            if (built == m_modelMeshScales.end() || built->second == transform.scale) return;
         }
-    }
+        col.mesh = buildModelMesh(m_taskPool, component.model, transform.scale);
+        m_modelMeshScales[entity] = transform.scale;
+        });
 }
-// Extract collision resolution to separate function
-void PhysicsWorld::resolveCollision(RigidBody& bodyA, Collider& colA, Transform& transA,
-    RigidBody& bodyB, Collider& colB, Transform& transB)
+
+TriangleMeshFuture PhysicsWorld::buildTriangleMesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices)
 {
-    glm::vec3 colA_halfExtents = colA.size * 0.5f;
-    glm::vec3 colB_halfExtents = colB.size * 0.5f;
+    return TriangleMesh::buildAsync(m_taskPool, std::move(vertices), std::move(indices));
+}
 
-    glm::vec3 minA = transA.position - colA_halfExtents;
-    glm::vec3 maxA = transA.position + colA_halfExtents;
-    glm::vec3 minB = transB.position - colB_halfExtents;
-    glm::vec3 maxB = transB.position + colB_halfExtents;
+void PhysicsWorld::updateBroadphase(float fixedDeltaTime)
+{
+    PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::BroadphaseBuild);
+    buildModelMeshes();
 
-    // Compute overlap
-    glm::vec3 overlap;
-    overlap.x = std::min(maxA.x - minB.x, maxB.x - minA.x);
-    overlap.y = std::min(maxA.y - minB.y, maxB.y - minA.y);
-    overlap.z = std::min(maxA.z - minB.z, maxB.z - minA.z);
+    // Only bodies that leave their fat AABB are reinserted into the tree
+    for (size_t i = 0; i < m_simBodies.size(); ++i) {
+        const SimBody& sim = m_simBodies[i];
+        if (!sim.collider) continue;
 
-    // Prioritize Y-axis stacking
-    if (overlap.y < overlap.x && overlap.y < overlap.z)
-    {
-        float push = overlap.y;
-
-        if (!bodyA.isKinematic && !bodyB.isKinematic)
-        {
-            bodyA.position.y -= push / 2.0f;
-            bodyB.position.y += push / 2.0f;
-            bodyA.velocity.y = 0.0f;
-            bodyB.velocity.y = 0.0f;
+        RigidBody& body = *sim.body;
+        Collider& col = *sim.collider;
+
+        // Toggling isStatic moves the proxy to the other tree
+        if (col.proxyId != -1 && isStaticProxy(col.proxyId) != body.isStatic) {
+            releaseProxy(col);
+        }
+
+        // Mesh colliders wait for their build, and never move
+        if (col.type == ColliderType::Mesh && (!body.isStatic || !col.getMesh())) {
+            if (col.proxyId != -1) releaseProxy(col);
+            continue;
         }
-        else if (!bodyA.isKinematic)
-        {
-            bodyA.position.y -= push;
-            bodyA.velocity.y = 0.0f;
+
+        if (col.proxyId == -1) {
+            AABB aabb = ShapeInstance::fromCollider(col, body.position, body.rotation).computeAABB();
+            uint32_t userData = static_cast<uint32_t>(sim.entity);
+            if (body.isStatic) {
+                // Bodies sleeping where the geometry appears would never notice it
+                wakeBodiesIn(aabb);
+                col.proxyId = m_broadphase.createStaticProxy(aabb, userData, col.layer, col.mask);
+            }
+            else {
+                col.proxyId = m_broadphase.createProxy(aabb, userData, col.layer, col.mask);
+            }
+            placeShape(col.proxyId, body, col);
         }
-        else if (!bodyB.isKinematic)
-        {
-            bodyB.position.y += push;
-            bodyB.velocity.y = 0.0f;
+        else {
+            // Filters may change on sleeping bodies too, this is a no-op when they don't
+            m_broadphase.setProxyFilter(col.proxyId, col.layer, col.mask);
+
+            if (!body.isSleeping && !body.isStatic) {
+                placeShape(col.proxyId, body, col);
+                m_broadphase.moveProxy(col.proxyId, m_proxyBounds[col.proxyId], body.velocity * fixedDeltaTime);
+            }
         }
+
+        // Sleeping bodies don't move, but the narrowphase still needs to find them
+        m_proxyOwners.reserveEntry(col.proxyId, -1);
+        m_proxyOwners[col.proxyId] = static_cast<int32_t>(i);
     }
-    else
+}
+
+void PhysicsWorld::detectCollision()
+{
+    // Phase 1: Broad phase - refresh the persistent pair set
     {
-        float pushX = overlap.x;
-        float pushZ = overlap.z;
+        PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::PairGeneration);
+        PHYSICS_STAT(m_stats.movedProxies = static_cast<uint32_t>(m_broadphase.getMoveCount()));
+        m_broadphase.updatePairs(&m_taskPool);
+    }
+    PHYSICS_SCOPED_TIMER(m_stats, PhysicsPhase::Narrowphase);
+
+    // Phase 2: Narrow phase - exact shape contact for every pair whose fat boxes overlap.
+    // Chunks only read components and write their own contact buffer.
+    const std::vector<uint64_t>& pairs = m_broadphase.getPairs();
+
+    size_t chunks = TaskPool::chunkCount(pairs.size(), kPairChunkSize);
+    if (m_chunkContacts.size() < chunks) {
+        m_chunkContacts.resize(chunks);
+    }
+
+    m_taskPool.parallelFor(pairs.size(), kPairChunkSize, [&](size_t begin, size_t end, size_t chunk) {
+        std::vector<ContactManifold>& contacts = m_chunkContacts[chunk];
+        contacts.clear();
 
-        if (!bodyA.isKinematic && !bodyB.isKinematic)
-        {
-            bodyA.position.x -= pushX / 2.0f;
-            bodyB.position.x += pushX / 2.0f;
+        for (size_t i = begin; i < end; ++i) {
+            const SimBody& simA = m_simBodies[m_proxyOwners[pairFirst(pairs[i])]];
+            const SimBody& simB = m_simBodies[m_proxyOwners[pairSecond(pairs[i])]];
+            const RigidBody& bodyA = *simA.body;
+            const RigidBody& bodyB = *simB.body;
+            const Collider& colA = *simA.collider;
+            const Collider& colB = *simB.collider;
 
-            bodyA.position.z -= pushZ / 2.0f;
-            bodyB.position.z += pushZ / 2.0f;
+            ContactManifold contact;
+            contact.pairId = pairs[i];
+            contact.entityA = static_cast<uint32_t>(simA.entity);
+            contact.entityB = static_cast<uint32_t>(simB.entity);
+
+            // Nothing moves between sleeping and static bodies, keep the cached contact
+            if ((bodyA.isSleeping || bodyA.isStatic) && (bodyB.isSleeping || bodyB.isStatic)) {
+                contact.asleep = true;
+                contact.isTrigger = colA.isTrigger || colB.isTrigger;
+                contacts.push_back(contact);
+                continue;
+            }
+
+            // Triggers only need to know about real overlap
+            contact.isTrigger = colA.isTrigger || colB.isTrigger;
+            float maxSeparation = contact.isTrigger ? 0.0f : kSpeculativeDistance;
+
+            const ShapeInstance& shapeA = m_proxyShapes[pairFirst(pairs[i])];
+            const ShapeInstance& shapeB = m_proxyShapes[pairSecond(pairs[i])];
+            if (!collideShapes(shapeA, shapeB, maxSeparation, contact)) {
+                continue;
+            }
+
+            contact.friction = std::sqrt(colA.friction * colB.friction);
+            contacts.push_back(contact);
         }
-        else if (!bodyA.isKinematic)
-        {
-            bodyA.position.x -= pushX;
-            bodyA.position.z -= pushZ;
+        });
+
+    // Phase 3: Serial, in chunk order, so results never depend on thread count
+    m_contacts.clear();
+    m_triggerContacts.clear();
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        for (ContactManifold& contact : m_chunkContacts[chunk]) {
+            const SimBody& simA = m_simBodies[m_proxyOwners[pairFirst(contact.pairId)]];
+            const SimBody& simB = m_simBodies[m_proxyOwners[pairSecond(contact.pairId)]];
+
+            // Triggers don't wake or push, they only feed events. Keep the trigger as entity A.
+            if (contact.isTrigger) {
+                if (!simA.collider->isTrigger) {
+                    std::swap(contact.entityA, contact.entityB);
+                    contact.normal = -contact.normal;
+                }
+                m_triggerContacts.push_back(contact);
+                continue;
+            }
+
+            RigidBody& bodyA = *simA.body;
+            RigidBody& bodyB = *simB.body;
+
+            if (!contact.asleep) {
+                // Anything still moving wakes the sleeping island it touches
+                auto isActive = [](const RigidBody& body) {
+                    return !body.isSleeping && glm::dot(body.velocity, body.velocity) > kLinearSleepTolerance * kLinearSleepTolerance;
+                    };
+                if (bodyA.isSleeping && isActive(bodyB)) wakeIsland(bodyA);
+                if (bodyB.isSleeping && isActive(bodyA)) wakeIsland(bodyB);
+            }
+
+            // Bodies woken above join the simulation next step, static until then
+            contact.bodyA = bodyA.storeIndex;
+            contact.bodyB = bodyB.storeIndex;
+            m_contacts.push_back(contact);
         }
-        else if (!bodyB.isKinematic)
-        {
-            bodyB.position.x += pushX;
-            bodyB.position.z += pushZ;
+    }
+
+    // Ground contacts: the terrain below the collider's box, or the floor plane
+    // acting on body centers like the clamp in integratePositions
+    for (const SimBody& sim : m_simBodies) {
+        if (!sim.collider) continue;
+
+        const RigidBody& body = *sim.body;
+        const Collider& col = *sim.collider;
+        if (body.isKinematic || body.isStatic || col.isTrigger || col.proxyId == -1) continue;
+
+        float separation = body.position.y - floorHeight;
+        glm::vec3 up(0.0f, 1.0f, 0.0f);
+        if (m_heightfield) {
+            float height;
+            m_heightfield->sample(body.position.x, body.position.z, height, up);
+            separation = (m_proxyBounds[col.proxyId].min.y - height) * up.y;
         }
+        if (separation > kSpeculativeDistance) continue;
+
+        ContactManifold contact;
+        contact.pairId = makePairId(static_cast<uint32_t>(col.proxyId), kGroundId);
+        contact.entityA = static_cast<uint32_t>(sim.entity);
+        contact.entityB = kGroundId;
+        contact.bodyA = body.storeIndex;
+        contact.asleep = body.isSleeping;
+        contact.normal = -up;
+        contact.separation = separation;
+        contact.friction = col.friction;
+        m_contacts.push_back(contact);
     }
 
-    // Sync transforms
-    transA.position = bodyA.position;
-    transB.position = bodyB.position;
-}
\ No newline at end of file
+    std::sort(m_contacts.begin(), m_contacts.end(), [](const ContactManifold& a, const ContactManifold& b) {
+        return a.pairId < b.pairId;
+        });
+
+    // Phase 4: Carry impulses over from last step's manifolds
+    m_contactCache.update(m_contacts);
+
+    // Touching awake dynamic bodies share an island
+    m_islandLinks.clear();
+    for (const ContactManifold& m : m_contactCache.getManifolds()) {
+        if (m.bodyA < 0 || m.bodyB < 0) continue;
+        if (m_bodyStore.isKinematic(m.bodyA) || m_bodyStore.isKinematic(m.bodyB)) continue;
+        m_islandLinks.emplace_back(m.bodyA, m.bodyB);
+    }
+}
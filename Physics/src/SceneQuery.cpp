@@ -0,0 +1,342 @@
+#include "SceneQuery.hpp"
+#include "DynamicTree.hpp"
+#include "SimdKernels.hpp"
+#include "StaticTree.hpp"
+#include "TriangleMesh.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+// Baseline SIMD for this file, AVX2 is chosen at runtime (SimdKernels.hpp)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_SIMD_SSE2 1
+#endif
+
+namespace {
+
+// Zero components become huge instead of infinite so 0 * inf can't produce NaN
+float safeInverse(float d)
+{
+    return 1.0f / (d != 0.0f ? d : 1e-20f);
+}
+
+// Entry distance into a sphere, 0 when the ray starts inside
+bool intersectRaySphere(const Ray& ray, const glm::vec3& center, float radius, float maxDistance, float& distance)
+{
+    glm::vec3 m = ray.origin - center;
+    float b = glm::dot(m, ray.direction);
+    float c = glm::dot(m, m) - radius * radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f) return false;
+
+    distance = std::max(-b - std::sqrt(discriminant), 0.0f);
+    return distance <= maxDistance && -b + std::sqrt(discriminant) >= 0.0f;
+}
+
+// Side of the capsule first, the end spheres cover whatever the side misses
+bool intersectRayCapsule(const Ray& ray, const ShapeInstance& shape, float radius, float maxDistance, float& distance, glm::vec3& normal)
+{
+    glm::vec3 a = shape.getSegmentA();
+    glm::vec3 axis = shape.rotation[1];
+    float length = 2.0f * shape.halfHeight;
+    glm::vec3 m = ray.origin - a;
+    float along = glm::clamp(glm::dot(m, axis), 0.0f, length);
+    glm::vec3 fromAxis = ray.origin - (a + axis * along);
+    if (glm::dot(fromAxis, fromAxis) <= radius * radius) {
+        distance = 0.0f;
+        normal = -ray.direction;
+        return true;
+    }
+
+    bool hit = false;
+    distance = maxDistance;
+    glm::vec3 d = ray.direction - axis * glm::dot(ray.direction, axis);
+    glm::vec3 p = m - axis * glm::dot(m, axis);
+    float qa = glm::dot(d, d);
+    float qb = glm::dot(p, d);
+    float qc = glm::dot(p, p) - radius * radius;
+    float discriminant = qb * qb - qa * qc;
+    if (qa > 1e-12f && discriminant >= 0.0f) {
+        float t = (-qb - std::sqrt(discriminant)) / qa;
+        float y = glm::dot(m + ray.direction * t, axis);
+        if (t >= 0.0f && t <= distance && y >= 0.0f && y <= length) {
+            hit = true;
+            distance = t;
+        }
+    }
+
+    float t;
+    if (intersectRaySphere(ray, a, radius, distance, t)) {
+        hit = true;
+        distance = t;
+    }
+    if (intersectRaySphere(ray, shape.getSegmentB(), radius, distance, t)) {
+        hit = true;
+        distance = t;
+    }
+    if (!hit) return false;
+
+    glm::vec3 point = ray.origin + ray.direction * distance;
+    along = glm::clamp(glm::dot(point - a, axis), 0.0f, length);
+    normal = glm::normalize(point - (a + axis * along));
+    return true;
+}
+
+static_assert(kRayPacketSize == kSimdWidth, "RayPacket lanes are one SIMD block");
+
+// Slab test of every lane against one box. Writes the entry distances and
+// returns the mask of lanes that hit before their tMax.
+#if defined(PHYSICS_SIMD_SSE2)
+
+uint32_t intersectPacketBaseline(const RayPacket& packet, const AABB& box, float* enter)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 minX = _mm_set1_ps(box.min.x), maxX = _mm_set1_ps(box.max.x);
+    const __m128 minY = _mm_set1_ps(box.min.y), maxY = _mm_set1_ps(box.max.y);
+    const __m128 minZ = _mm_set1_ps(box.min.z), maxZ = _mm_set1_ps(box.max.z);
+    uint32_t mask = 0;
+
+    // Two 4-wide halves
+    for (size_t half = 0; half < 2; ++half) {
+        size_t j = half * 4;
+        __m128 ox = _mm_load_ps(packet.ox + j);
+        __m128 oy = _mm_load_ps(packet.oy + j);
+        __m128 oz = _mm_load_ps(packet.oz + j);
+
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(minX, ox), _mm_load_ps(packet.ix + j));
+        __m128 t2x = _mm_mul_ps(_mm_sub_ps(maxX, ox), _mm_load_ps(packet.ix + j));
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(minY, oy), _mm_load_ps(packet.iy + j));
+        __m128 t2y = _mm_mul_ps(_mm_sub_ps(maxY, oy), _mm_load_ps(packet.iy + j));
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(minZ, oz), _mm_load_ps(packet.iz + j));
+        __m128 t2z = _mm_mul_ps(_mm_sub_ps(maxZ, oz), _mm_load_ps(packet.iz + j));
+
+        __m128 tEnter = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+            _mm_max_ps(_mm_min_ps(t1z, t2z), zero));
+        __m128 tExit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+            _mm_min_ps(_mm_max_ps(t1z, t2z), _mm_load_ps(packet.tMax + j)));
+
+        _mm_store_ps(enter + j, tEnter);
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tEnter, tExit))) << j;
+    }
+    return mask;
+}
+
+#else
+
+uint32_t intersectPacketBaseline(const RayPacket& packet, const AABB& box, float* enter)
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kRayPacketSize; ++i) {
+        float t1x = (box.min.x - packet.ox[i]) * packet.ix[i], t2x = (box.max.x - packet.ox[i]) * packet.ix[i];
+        float t1y = (box.min.y - packet.oy[i]) * packet.iy[i], t2y = (box.max.y - packet.oy[i]) * packet.iy[i];
+        float t1z = (box.min.z - packet.oz[i]) * packet.iz[i], t2z = (box.max.z - packet.oz[i]) * packet.iz[i];
+
+        float tEnter = std::max(std::max(std::min(t1x, t2x), std::min(t1y, t2y)), std::max(std::min(t1z, t2z), 0.0f));
+        float tExit = std::min(std::min(std::max(t1x, t2x), std::max(t1y, t2y)), std::min(std::max(t1z, t2z), packet.tMax[i]));
+
+        enter[i] = tEnter;
+        if (tEnter <= tExit) mask |= 1u << i;
+    }
+    return mask;
+}
+
+#endif
+
+uint32_t intersectPacket(const RayPacket& packet, const AABB& box, float* enter)
+{
+#if PHYSICS_HAVE_AVX2
+    if (cpuHasAvx2()) {
+        return avx2::intersectPacket(packet, box, enter);
+    }
+#endif
+    return intersectPacketBaseline(packet, box, enter);
+}
+
+int32_t getLeafProxy(const TreeNode&, int32_t nodeId) { return nodeId; }
+int32_t getLeafProxy(const StaticNode& node, int32_t) { return node.proxyId; }
+
+// Walks one tree with the packet, shrinking each lane's tMax to its closest
+// leaf so far. Returns the mask of lanes whose best hit is now in this tree.
+// Each lane that hits a leaf box is refined against the exact shape.
+template<typename Tree>
+uint32_t tracePacket(const Tree& tree, const std::vector<AABB>& leafBounds, const std::vector<ShapeInstance>& shapes,
+    const Ray* rays, RayPacket& packet, int32_t* bestProxy)
+{
+    alignas(32) float enter[kRayPacketSize];
+    uint32_t improved = 0;
+
+    TreeStack stack;
+    stack.push(tree.getRoot());
+
+    while (!stack.empty()) {
+        int32_t nodeId = stack.pop();
+        if (nodeId == kNullNode) continue;
+
+        const auto& node = tree.getNode(nodeId);
+        if (!intersectPacket(packet, node.aabb, enter)) continue;
+
+        if (!node.isLeaf()) {
+            stack.push(node.child1);
+            stack.push(node.child2);
+            continue;
+        }
+
+        // Tight box of the leaf, keep the closest hit per lane
+        int32_t proxyId = getLeafProxy(node, nodeId);
+        uint32_t mask = intersectPacket(packet, leafBounds[proxyId], enter);
+        for (uint32_t lanes = mask; lanes; lanes &= lanes - 1) {
+            int lane = std::countr_zero(lanes);
+            glm::vec3 normal;
+            if (!intersectRayShape(rays[lane], shapes[proxyId], leafBounds[proxyId], packet.tMax[lane], enter[lane], normal)) {
+                mask &= ~(1u << lane);
+            }
+        }
+        for (; mask; mask &= mask - 1) {
+            int lane = std::countr_zero(mask);
+            if (enter[lane] < packet.tMax[lane] || bestProxy[lane] == kNullNode) {
+                packet.tMax[lane] = enter[lane];
+                bestProxy[lane] = proxyId;
+                improved |= 1u << lane;
+            }
+        }
+    }
+    return improved;
+}
+
+}
+
+bool intersectRayAABB(const Ray& ray, const AABB& box, float maxDistance, float& distance, glm::vec3& normal)
+{
+    float enter = 0.0f;
+    float exit = maxDistance;
+    int enterAxis = -1;
+    float enterSign = 0.0f;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        float inverse = safeInverse(ray.direction[axis]);
+        float t1 = (box.min[axis] - ray.origin[axis]) * inverse;
+        float t2 = (box.max[axis] - ray.origin[axis]) * inverse;
+
+        // t1 is the near slab, entered through the face facing against the ray
+        float sign = -1.0f;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+            sign = 1.0f;
+        }
+
+        if (t1 > enter) {
+            enter = t1;
+            enterAxis = axis;
+            enterSign = sign;
+        }
+        exit = std::min(exit, t2);
+        if (enter > exit) return false;
+    }
+
+    distance = enter;
+    normal = glm::vec3(0.0f);
+    if (enterAxis != -1) {
+        normal[enterAxis] = enterSign;
+    }
+    else {
+        // Started inside, report the reversed direction
+        normal = -ray.direction;
+    }
+    return true;
+}
+
+bool intersectRayShape(const Ray& ray, const ShapeInstance& shape, const AABB& bounds, float maxDistance, float& distance, glm::vec3& normal,
+    float inflate)
+{
+    if (!intersectRayAABB(ray, bounds, maxDistance, distance, normal)) return false;
+
+    switch (shape.type) {
+    case ColliderType::Sphere: {
+        float radius = shape.radius + inflate;
+        glm::vec3 m = ray.origin - shape.center;
+        if (glm::dot(m, m) <= radius * radius) {
+            distance = 0.0f;
+            normal = -ray.direction;
+            return true;
+        }
+        if (!intersectRaySphere(ray, shape.center, radius, maxDistance, distance)) return false;
+        normal = glm::normalize(ray.origin + ray.direction * distance - shape.center);
+        return true;
+    }
+    case ColliderType::Capsule:
+        return intersectRayCapsule(ray, shape, shape.radius + inflate, maxDistance, distance, normal);
+    case ColliderType::Box: {
+        // Slab test in the box frame. Inflated corners stay square, slightly
+        // generous for swept bullets but never missing a hit.
+        glm::mat3 toLocal = glm::transpose(shape.rotation);
+        Ray local;
+        local.origin = toLocal * (ray.origin - shape.center);
+        local.direction = toLocal * ray.direction;
+        glm::vec3 extents = shape.halfExtents + glm::vec3(inflate);
+        glm::vec3 localNormal;
+        if (!intersectRayAABB(local, AABB(-extents, extents), maxDistance, distance, localNormal)) return false;
+        normal = shape.rotation * localNormal;
+        return true;
+    }
+    default:
+        break;
+    }
+
+    if (!shape.mesh) return false;
+
+    glm::mat3 toLocal = glm::transpose(shape.rotation);
+    glm::vec3 localNormal;
+    if (!shape.mesh->raycast(toLocal * (ray.origin - shape.center), toLocal * ray.direction, maxDistance, distance, localNormal)) {
+        return false;
+    }
+    normal = shape.rotation * localNormal;
+    return true;
+}
+
+void raycastPacket(const DynamicTree& tree, const std::vector<AABB>& leafBounds, const std::vector<ShapeInstance>& shapes,
+    const StaticTree& staticTree, const std::vector<AABB>& staticBounds, const std::vector<ShapeInstance>& staticShapes,
+    const Ray* rays, size_t count, RaycastHit* hits)
+{
+    RayPacket packet;
+    int32_t bestProxy[kRayPacketSize];
+
+    // Unused lanes repeat the first ray, their tMax < 0 keeps them from hitting
+    count = std::min(count, kRayPacketSize);
+    Ray lanes[kRayPacketSize];
+    for (size_t i = 0; i < kRayPacketSize; ++i) {
+        lanes[i] = rays[i < count ? i : 0];
+        const Ray& ray = lanes[i];
+        packet.ox[i] = ray.origin.x;
+        packet.oy[i] = ray.origin.y;
+        packet.oz[i] = ray.origin.z;
+        packet.ix[i] = safeInverse(ray.direction.x);
+        packet.iy[i] = safeInverse(ray.direction.y);
+        packet.iz[i] = safeInverse(ray.direction.z);
+        packet.tMax[i] = i < count ? ray.maxDistance : -1.0f;
+        bestProxy[i] = kNullNode;
+    }
+
+    // The static tree starts from the dynamic hits, so it only has to beat them
+    tracePacket(tree, leafBounds, shapes, lanes, packet, bestProxy);
+    uint32_t staticLanes = tracePacket(staticTree, staticBounds, staticShapes, lanes, packet, bestProxy);
+
+    // Point and normal for the winners only
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = RaycastHit();
+        if (bestProxy[i] == kNullNode) continue;
+
+        bool isStatic = (staticLanes >> i) & 1u;
+        const AABB& bounds = isStatic ? staticBounds[bestProxy[i]] : leafBounds[bestProxy[i]];
+        const ShapeInstance& shape = isStatic ? staticShapes[bestProxy[i]] : shapes[bestProxy[i]];
+
+        float distance;
+        glm::vec3 normal;
+        if (intersectRayShape(rays[i], shape, bounds, rays[i].maxDistance, distance, normal)) {
+            hits[i].body = static_cast<entt::entity>(isStatic ? staticTree.getUserData(bestProxy[i]) : tree.getUserData(bestProxy[i]));
+            hits[i].distance = distance;
+            hits[i].point = rays[i].origin + rays[i].direction * distance;
+            hits[i].normal = normal;
+        }
+    }
+}
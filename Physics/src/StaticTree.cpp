@@ -0,0 +1,95 @@
+#include "StaticTree.hpp"
+
+int32_t StaticTree::createProxy(const AABB& aabb, uint32_t userData)
+{
+    int32_t proxyId;
+    if (!m_freeProxies.empty()) {
+        proxyId = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    }
+    else {
+        proxyId = static_cast<int32_t>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+
+    Proxy& proxy = m_proxies[proxyId];
+    proxy.aabb = aabb;
+    proxy.userData = userData;
+    proxy.alive = true;
+
+    ++m_proxyCount;
+    m_dirty = true;
+    return proxyId;
+}
+
+void StaticTree::destroyProxy(int32_t proxyId)
+{
+    m_proxies[proxyId].alive = false;
+    m_freeProxies.push_back(proxyId);
+
+    --m_proxyCount;
+    m_dirty = true;
+}
+
+void StaticTree::build()
+{
+    m_dirty = false;
+    m_nodes.clear();
+    m_buildOrder.clear();
+
+    for (int32_t i = 0; i < static_cast<int32_t>(m_proxies.size()); ++i) {
+        if (m_proxies[i].alive) m_buildOrder.push_back(i);
+    }
+    if (m_buildOrder.empty()) return;
+
+    m_nodes.reserve(2 * m_buildOrder.size() - 1);
+    buildRange(0, m_buildOrder.size());
+}
+
+int32_t StaticTree::buildRange(size_t begin, size_t end)
+{
+    int32_t nodeId = static_cast<int32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    if (end - begin == 1) {
+        m_nodes[nodeId].aabb = m_proxies[m_buildOrder[begin]].aabb;
+        m_nodes[nodeId].proxyId = m_buildOrder[begin];
+        return nodeId;
+    }
+
+    // Split at the median centroid along the widest axis of the centroids
+    AABB bounds = m_proxies[m_buildOrder[begin]].aabb;
+    glm::vec3 centroidMin = bounds.getCenter();
+    glm::vec3 centroidMax = centroidMin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        const AABB& aabb = m_proxies[m_buildOrder[i]].aabb;
+        bounds = AABB::merge(bounds, aabb);
+        centroidMin = glm::min(centroidMin, aabb.getCenter());
+        centroidMax = glm::max(centroidMax, aabb.getCenter());
+    }
+
+    glm::vec3 spread = centroidMax - centroidMin;
+    int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(m_buildOrder.begin() + begin, m_buildOrder.begin() + middle, m_buildOrder.begin() + end,
+        [&](int32_t a, int32_t b) {
+            return m_proxies[a].aabb.getCenter()[axis] < m_proxies[b].aabb.getCenter()[axis];
+        });
+
+    // The left child always directly follows its parent
+    int32_t child1 = buildRange(begin, middle);
+    int32_t child2 = buildRange(middle, end);
+
+    StaticNode& node = m_nodes[nodeId];
+    node.aabb = bounds;
+    node.child1 = child1;
+    node.child2 = child2;
+    return nodeId;
+}
+
+size_t StaticTree::getMemoryUsage() const
+{
+    return m_proxies.capacity() * sizeof(Proxy) + m_nodes.capacity() * sizeof(StaticNode) +
+        (m_freeProxies.capacity() + m_buildOrder.capacity()) * sizeof(int32_t);
+}
@@ -0,0 +1,133 @@
+#include "SweepAndPrune.hpp"
+#include <Broadphase.hpp>
+
+void SweepAndPrune::addProxy(int32_t proxyId, const AABB& aabb)
+{
+    if (proxyId >= static_cast<int32_t>(m_boxes.size())) {
+        m_boxes.resize(proxyId + 1);
+    }
+
+    Box& box = m_boxes[proxyId];
+    box.aabb = aabb;
+    box.active = true;
+
+    // Append at the end of every axis, the next sort sinks them into place and reports overlaps
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+
+        box.minIndex[axis] = static_cast<uint32_t>(endpoints.size());
+        endpoints.push_back({ aabb.min[axis], static_cast<uint32_t>(proxyId) << 1 });
+
+        box.maxIndex[axis] = static_cast<uint32_t>(endpoints.size());
+        endpoints.push_back({ aabb.max[axis], (static_cast<uint32_t>(proxyId) << 1) | 1u });
+    }
+    m_dirty = true;
+}
+
+void SweepAndPrune::updateProxy(int32_t proxyId, const AABB& aabb)
+{
+    Box& box = m_boxes[proxyId];
+    box.aabb = aabb;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        m_endpoints[axis][box.minIndex[axis]].value = aabb.min[axis];
+        m_endpoints[axis][box.maxIndex[axis]].value = aabb.max[axis];
+    }
+    m_dirty = true;
+}
+
+void SweepAndPrune::removeProxy(int32_t proxyId)
+{
+    Box& box = m_boxes[proxyId];
+    box.active = false;
+
+    // Removal is rare, compact the arrays and fix up the stored indices
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+
+        uint32_t write = 0;
+        for (uint32_t read = 0; read < endpoints.size(); ++read) {
+            const Endpoint endpoint = endpoints[read];
+            if (endpoint.proxyId() == proxyId) continue;
+
+            endpoints[write] = endpoint;
+            Box& owner = m_boxes[endpoint.proxyId()];
+            if (endpoint.isMax()) owner.maxIndex[axis] = write;
+            else owner.minIndex[axis] = write;
+            ++write;
+        }
+        endpoints.resize(write);
+    }
+}
+
+void SweepAndPrune::clear()
+{
+    for (auto& endpoints : m_endpoints) {
+        endpoints.clear();
+    }
+    m_boxes.clear();
+    m_dirty = false;
+}
+
+void SweepAndPrune::updatePairs(std::vector<uint64_t>& added, std::vector<uint64_t>& removed)
+{
+    if (!m_dirty) return;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        sortAxis(axis, added, removed);
+    }
+    m_dirty = false;
+}
+
+void SweepAndPrune::sortAxis(int axis, std::vector<uint64_t>& added, std::vector<uint64_t>& removed)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    const uint32_t count = static_cast<uint32_t>(endpoints.size());
+
+    for (uint32_t i = 1; i < count; ++i) {
+        const Endpoint key = endpoints[i];
+        const int32_t keyProxy = key.proxyId();
+        uint32_t j = i;
+
+        // Sink the endpoint left, every endpoint it passes is a potential overlap change
+        while (j > 0 && key.value < endpoints[j - 1].value) {
+            const Endpoint other = endpoints[j - 1];
+            const int32_t otherProxy = other.proxyId();
+
+            if (key.isMax() != other.isMax() && keyProxy != otherProxy) {
+                uint64_t pairId = makePairId(static_cast<uint32_t>(keyProxy), static_cast<uint32_t>(otherProxy));
+
+                if (!key.isMax()) {
+                    // Our min passed their max: overlapping on this axis again
+                    if (m_boxes[keyProxy].aabb.overlaps(m_boxes[otherProxy].aabb)) {
+                        added.push_back(pairId);
+                    }
+                }
+                else {
+                    // Our max passed their min: separated on this axis
+                    removed.push_back(pairId);
+                }
+            }
+
+            endpoints[j] = other;
+            Box& otherBox = m_boxes[otherProxy];
+            if (other.isMax()) otherBox.maxIndex[axis] = j;
+            else otherBox.minIndex[axis] = j;
+            --j;
+        }
+
+        endpoints[j] = key;
+        Box& keyBox = m_boxes[keyProxy];
+        if (key.isMax()) keyBox.maxIndex[axis] = j;
+        else keyBox.minIndex[axis] = j;
+    }
+}
+
+size_t SweepAndPrune::getMemoryUsage() const
+{
+    size_t bytes = m_boxes.capacity() * sizeof(Box);
+    for (const auto& endpoints : m_endpoints) {
+        bytes += endpoints.capacity() * sizeof(Endpoint);
+    }
+    return bytes;
+}
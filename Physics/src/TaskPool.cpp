@@ -0,0 +1,170 @@
+#include "TaskPool.hpp"
+#include <algorithm>
+
+TaskPool::TaskPool(uint32_t workerCount)
+{
+    start(workerCount);
+}
+
+TaskPool::~TaskPool()
+{
+    stop();
+}
+
+void TaskPool::setWorkerCount(uint32_t workerCount)
+{
+    stop();
+    start(workerCount);
+
+    // Queued jobs wait for the new workers, or run now if there are none
+    if (m_workers.empty()) {
+        std::deque<std::function<void()>> jobs;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            jobs.swap(m_jobs);
+        }
+        for (auto& job : jobs) {
+            job();
+        }
+    }
+    else {
+        m_wakeCV.notify_all();
+    }
+}
+
+void TaskPool::submit(std::function<void()> job)
+{
+    if (m_workers.empty()) {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_wakeCV.notify_one();
+}
+
+void TaskPool::start(uint32_t workerCount)
+{
+    if (workerCount == kHardwareWorkers) {
+        uint32_t hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    m_shouldExit = false;
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&TaskPool::workerLoop, this);
+    }
+}
+
+void TaskPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldExit = true;
+    }
+    m_wakeCV.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+void TaskPool::parallelFor(size_t count, size_t chunkSize, const Task& task)
+{
+    if (count == 0) return;
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    size_t chunks = chunkCount(count, chunkSize);
+
+    // Not worth waking anyone
+    if (m_workers.empty() || chunks == 1) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t begin = chunk * chunkSize;
+            task(begin, std::min(begin + chunkSize, count), chunk);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_chunkSize = chunkSize;
+        m_chunkCount = chunks;
+        m_nextChunk = 0;
+        m_pendingChunks = chunks;
+        ++m_generation;
+    }
+    m_wakeCV.notify_all();
+
+    runChunks();
+
+    // Wait for the last chunk and for every worker to let go of the job
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCV.wait(lock, [this] {
+        return m_pendingChunks == 0 && m_activeWorkers == 0;
+        });
+    m_task = nullptr;
+}
+
+void TaskPool::runChunks()
+{
+    while (true) {
+        size_t chunk = m_nextChunk.fetch_add(1);
+        if (chunk >= m_chunkCount) break;
+
+        size_t begin = chunk * m_chunkSize;
+        (*m_task)(begin, std::min(begin + m_chunkSize, m_count), chunk);
+
+        if (m_pendingChunks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doneCV.notify_all();
+        }
+    }
+}
+
+void TaskPool::workerLoop()
+{
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCV.wait(lock, [&] {
+                return m_shouldExit || (m_generation != seenGeneration && m_task != nullptr) || !m_jobs.empty();
+                });
+
+            if (m_shouldExit) return;
+
+            if (m_generation != seenGeneration && m_task != nullptr) {
+                seenGeneration = m_generation;
+                ++m_activeWorkers;
+            }
+            else {
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+        }
+
+        if (job) {
+            job();
+            continue;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeWorkers;
+        }
+        m_doneCV.notify_all();
+    }
+}
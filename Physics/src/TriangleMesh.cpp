@@ -0,0 +1,245 @@
+#include "TriangleMesh.hpp"
+#include "TaskPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kQuantMax = 65535.0f;
+constexpr float kDegenerateArea = 1e-12f;
+
+}
+
+TriangleMesh::TriangleMesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices)
+    : m_vertices(std::move(vertices))
+{
+    // Keep the triangles that can be hit, with their boxes for the build
+    std::vector<uint32_t> sources;
+    std::vector<AABB> bounds;
+    sources.reserve(indices.size() / 3);
+    bounds.reserve(indices.size() / 3);
+
+    const uint32_t vertexCount = static_cast<uint32_t>(m_vertices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) continue;
+
+        const glm::vec3& a = m_vertices[indices[i]];
+        const glm::vec3& b = m_vertices[indices[i + 1]];
+        const glm::vec3& c = m_vertices[indices[i + 2]];
+        glm::vec3 n = glm::cross(b - a, c - a);
+        if (glm::dot(n, n) < kDegenerateArea) continue;
+
+        sources.push_back(static_cast<uint32_t>(i / 3));
+        bounds.push_back(AABB(glm::min(glm::min(a, b), c), glm::max(glm::max(a, b), c)));
+    }
+    if (sources.empty()) return;
+
+    m_bounds = bounds.front();
+    for (const AABB& aabb : bounds) {
+        m_bounds = AABB::merge(m_bounds, aabb);
+    }
+
+    // Flat meshes get a zero extent axis, which then quantizes to 0 everywhere
+    glm::vec3 extent = m_bounds.max - m_bounds.min;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_quantScale[axis] = extent[axis] > 0.0f ? kQuantMax / extent[axis] : 0.0f;
+        m_quantInvScale[axis] = extent[axis] > 0.0f ? extent[axis] / kQuantMax : 0.0f;
+    }
+
+    // The build shuffles positions into sources/bounds, leaves then own ranges of it
+    std::vector<uint32_t> order(sources.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    m_nodes.reserve(2 * (order.size() / kMaxLeafTriangles + 1));
+    buildRange(order, bounds, 0, order.size());
+
+    m_indices.resize(order.size() * 3);
+    for (size_t i = 0; i < order.size(); ++i) {
+        uint32_t source = sources[order[i]];
+        m_indices[3 * i] = indices[3 * source];
+        m_indices[3 * i + 1] = indices[3 * source + 1];
+        m_indices[3 * i + 2] = indices[3 * source + 2];
+    }
+}
+
+void TriangleMeshFuture::wait() const
+{
+    if (m_state) {
+        m_state->ready.wait(false, std::memory_order_acquire);
+    }
+}
+
+TriangleMeshFuture TriangleMesh::buildAsync(TaskPool& pool, std::vector<glm::vec3> vertices, std::vector<uint32_t> indices)
+{
+    return buildAsync(pool, [vertices = std::move(vertices), indices = std::move(indices)]() mutable {
+        return std::shared_ptr<const TriangleMesh>(std::make_shared<TriangleMesh>(std::move(vertices), std::move(indices)));
+        });
+}
+
+TriangleMeshFuture TriangleMesh::buildAsync(TaskPool& pool, std::function<std::shared_ptr<const TriangleMesh>()> build)
+{
+    TriangleMeshFuture future;
+    future.m_state = std::make_shared<TriangleMeshFuture::State>();
+
+    pool.submit([state = std::weak_ptr<TriangleMeshFuture::State>(future.m_state), build = std::move(build)]() {
+        // Every collider let go before the job came up
+        std::shared_ptr<TriangleMeshFuture::State> owner = state.lock();
+        if (!owner) return;
+
+        owner->mesh = build();
+        owner->ready.store(true, std::memory_order_release);
+        owner->ready.notify_all();
+        });
+    return future;
+}
+
+uint32_t TriangleMesh::buildRange(std::vector<uint32_t>& order, const std::vector<AABB>& bounds, size_t begin, size_t end)
+{
+    uint32_t nodeId = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    AABB box = bounds[order[begin]];
+    glm::vec3 centroidMin = box.getCenter();
+    glm::vec3 centroidMax = centroidMin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        const AABB& aabb = bounds[order[i]];
+        box = AABB::merge(box, aabb);
+        centroidMin = glm::min(centroidMin, aabb.getCenter());
+        centroidMax = glm::max(centroidMax, aabb.getCenter());
+    }
+
+    QuantizedBox quantized = quantize(box);
+    std::copy(quantized.min, quantized.min + 3, m_nodes[nodeId].min);
+    std::copy(quantized.max, quantized.max + 3, m_nodes[nodeId].max);
+
+    if (end - begin <= kMaxLeafTriangles) {
+        m_nodes[nodeId].data = kLeafBit | (static_cast<uint32_t>(begin) << kLeafCountBits) | static_cast<uint32_t>(end - begin);
+        return nodeId;
+    }
+
+    // Median split along the widest axis of the centroids, like StaticTree
+    glm::vec3 spread = centroidMax - centroidMin;
+    int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+        [&](uint32_t a, uint32_t b) {
+            return bounds[a].getCenter()[axis] < bounds[b].getCenter()[axis];
+        });
+
+    buildRange(order, bounds, begin, middle);
+    uint32_t child2 = buildRange(order, bounds, middle, end);
+    m_nodes[nodeId].data = child2;
+    return nodeId;
+}
+
+TriangleMesh::QuantizedBox TriangleMesh::quantize(const AABB& aabb) const
+{
+    QuantizedBox box;
+    for (int axis = 0; axis < 3; ++axis) {
+        float lo = (aabb.min[axis] - m_bounds.min[axis]) * m_quantScale[axis];
+        float hi = (aabb.max[axis] - m_bounds.min[axis]) * m_quantScale[axis];
+        box.min[axis] = static_cast<uint16_t>(std::clamp(std::floor(lo), 0.0f, kQuantMax));
+        box.max[axis] = static_cast<uint16_t>(std::clamp(std::ceil(hi), 0.0f, kQuantMax));
+    }
+    return box;
+}
+
+AABB TriangleMesh::dequantize(const Node& node) const
+{
+    glm::vec3 lo(node.min[0], node.min[1], node.min[2]);
+    glm::vec3 hi(node.max[0], node.max[1], node.max[2]);
+    return AABB(m_bounds.min + lo * m_quantInvScale, m_bounds.min + hi * m_quantInvScale);
+}
+
+bool TriangleMesh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance, glm::vec3& normal) const
+{
+    if (m_nodes.empty()) return false;
+
+    glm::vec3 invDirection;
+    for (int axis = 0; axis < 3; ++axis) {
+        float d = direction[axis];
+        invDirection[axis] = 1.0f / (d != 0.0f ? d : 1e-20f);
+    }
+
+    auto enterNode = [&](const Node& node, float& enter) {
+        AABB box = dequantize(node);
+        glm::vec3 t1 = (box.min - origin) * invDirection;
+        glm::vec3 t2 = (box.max - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t1, t2);
+        glm::vec3 tFar = glm::max(t1, t2);
+        enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return enter <= exit;
+        };
+
+    bool hit = false;
+    float enter;
+    if (!enterNode(m_nodes[0], enter)) return false;
+
+    TreeStack stack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+        uint32_t nodeId = static_cast<uint32_t>(stack.pop());
+        const Node& node = m_nodes[nodeId];
+
+        if (node.isLeaf()) {
+            uint32_t first = node.getFirstTriangle();
+            for (uint32_t i = first; i < first + node.getTriangleCount(); ++i) {
+                // Moller-Trumbore, both faces
+                glm::vec3 a, b, c;
+                getTriangle(i, a, b, c);
+                glm::vec3 e1 = b - a;
+                glm::vec3 e2 = c - a;
+                glm::vec3 p = glm::cross(direction, e2);
+                float det = glm::dot(e1, p);
+                if (std::abs(det) < 1e-12f) continue;
+
+                float invDet = 1.0f / det;
+                glm::vec3 s = origin - a;
+                float u = glm::dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+                glm::vec3 q = glm::cross(s, e1);
+                float v = glm::dot(direction, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+
+                float t = glm::dot(e2, q) * invDet;
+                if (t < 0.0f || t > maxDistance) continue;
+
+                maxDistance = t;
+                normal = glm::normalize(glm::cross(e1, e2));
+                if (glm::dot(normal, direction) > 0.0f) normal = -normal;
+                hit = true;
+            }
+            continue;
+        }
+
+        // Nearer child on top of the stack so the far one is often culled by then
+        uint32_t child1 = nodeId + 1;
+        uint32_t child2 = node.data;
+        float enter1, enter2;
+        bool hit1 = enterNode(m_nodes[child1], enter1);
+        bool hit2 = enterNode(m_nodes[child2], enter2);
+        if (hit1 && hit2) {
+            bool firstIsNear = enter1 <= enter2;
+            stack.push(static_cast<int32_t>(firstIsNear ? child2 : child1));
+            stack.push(static_cast<int32_t>(firstIsNear ? child1 : child2));
+        }
+        else if (hit1) {
+            stack.push(static_cast<int32_t>(child1));
+        }
+        else if (hit2) {
+            stack.push(static_cast<int32_t>(child2));
+        }
+    }
+
+    if (hit) distance = maxDistance;
+    return hit;
+}
+
+size_t TriangleMesh::getMemoryUsage() const
+{
+    return m_vertices.capacity() * sizeof(glm::vec3) + m_indices.capacity() * sizeof(uint32_t) +
+        m_nodes.capacity() * sizeof(Node);
+}
@@ -0,0 +1,20 @@
+#include "SimdKernels.hpp"
+#include <immintrin.h>
+
+namespace avx2 {
+
+uint32_t overlapMask(const float* minX, const float* minY, const float* minZ,
+    const float* maxX, const float* maxY, const float* maxZ, size_t begin, const AABB& aabb)
+{
+    // Overlap is !(max < other.min || min > other.max) on every axis
+    __m256 hit = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_load_ps(maxX + begin), _mm256_set1_ps(aabb.min.x), _CMP_GE_OQ),
+        _mm256_cmp_ps(_mm256_load_ps(minX + begin), _mm256_set1_ps(aabb.max.x), _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_load_ps(maxY + begin), _mm256_set1_ps(aabb.min.y), _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_load_ps(minY + begin), _mm256_set1_ps(aabb.max.y), _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_load_ps(maxZ + begin), _mm256_set1_ps(aabb.min.z), _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_load_ps(minZ + begin), _mm256_set1_ps(aabb.max.z), _CMP_LE_OQ));
+    return static_cast<uint32_t>(_mm256_movemask_ps(hit));
+}
+
+} // namespace avx2
@@ -0,0 +1,53 @@
+#include "SimdKernels.hpp"
+#include <immintrin.h>
+
+namespace avx2 {
+
+void integrateVelocities(float* vy, const uint64_t* gravityBits, const uint64_t* kinematicBits, size_t padded,
+    float gravityStep)
+{
+    const __m256 step = _mm256_set1_ps(gravityStep);
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+    for (size_t i = 0; i < padded; i += 8) {
+        // Same 8 lane mask as BodyStore::gravityMask
+        uint64_t word = gravityBits[i >> 6] & ~kinematicBits[i >> 6];
+        int mask = static_cast<int>((word >> (i & 63)) & 0xFFu);
+
+        __m256i bits = _mm256_and_si256(_mm256_set1_epi32(mask), laneBits);
+        __m256 gravityLanes = _mm256_castsi256_ps(_mm256_cmpeq_epi32(bits, laneBits));
+
+        __m256 vely = _mm256_add_ps(_mm256_load_ps(vy + i), _mm256_and_ps(gravityLanes, step));
+        _mm256_store_ps(vy + i, vely);
+    }
+}
+
+void integratePositions(float* px, float* py, float* pz, const float* vx, float* vy, const float* vz, size_t padded,
+    float dt, float floorY)
+{
+    const __m256 dtv = _mm256_set1_ps(dt);
+    const __m256 floorv = _mm256_set1_ps(floorY);
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (size_t i = 0; i < padded; i += 8) {
+        __m256 velx = _mm256_load_ps(vx + i);
+        __m256 vely = _mm256_load_ps(vy + i);
+        __m256 velz = _mm256_load_ps(vz + i);
+
+        __m256 posx = _mm256_add_ps(_mm256_load_ps(px + i), _mm256_mul_ps(velx, dtv));
+        __m256 posy = _mm256_add_ps(_mm256_load_ps(py + i), _mm256_mul_ps(vely, dtv));
+        __m256 posz = _mm256_add_ps(_mm256_load_ps(pz + i), _mm256_mul_ps(velz, dtv));
+
+        __m256 below = _mm256_cmp_ps(posy, floorv, _CMP_LT_OQ);
+        posy = _mm256_blendv_ps(posy, floorv, below);
+        __m256 falling = _mm256_and_ps(below, _mm256_cmp_ps(vely, zero, _CMP_LT_OQ));
+        vely = _mm256_blendv_ps(vely, zero, falling);
+
+        _mm256_store_ps(px + i, posx);
+        _mm256_store_ps(py + i, posy);
+        _mm256_store_ps(pz + i, posz);
+        _mm256_store_ps(vy + i, vely);
+    }
+}
+
+} // namespace avx2
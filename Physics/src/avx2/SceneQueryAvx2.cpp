@@ -0,0 +1,32 @@
+#include "SimdKernels.hpp"
+#include <immintrin.h>
+
+namespace avx2 {
+
+uint32_t intersectPacket(const RayPacket& packet, const AABB& box, float* enter)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 ix = _mm256_load_ps(packet.ix);
+    __m256 iy = _mm256_load_ps(packet.iy);
+    __m256 iz = _mm256_load_ps(packet.iz);
+    __m256 ox = _mm256_load_ps(packet.ox);
+    __m256 oy = _mm256_load_ps(packet.oy);
+    __m256 oz = _mm256_load_ps(packet.oz);
+
+    __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.x), ox), ix);
+    __m256 t2x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.x), ox), ix);
+    __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.y), oy), iy);
+    __m256 t2y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.y), oy), iy);
+    __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.z), oz), iz);
+    __m256 t2z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.z), oz), iz);
+
+    __m256 tEnter = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t1x, t2x), _mm256_min_ps(t1y, t2y)),
+        _mm256_max_ps(_mm256_min_ps(t1z, t2z), zero));
+    __m256 tExit = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t1x, t2x), _mm256_max_ps(t1y, t2y)),
+        _mm256_min_ps(_mm256_max_ps(t1z, t2z), _mm256_load_ps(packet.tMax)));
+
+    _mm256_store_ps(enter, tEnter);
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(tEnter, tExit, _CMP_LE_OQ)));
+}
+
+} // namespace avx2
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Scene;
+class PhysicsWorld;
+
+// A canned world for the benchmark. build() fills a fresh headless scene and
+// the world attached to it, always with the same seed so runs can be diffed.
+struct BenchScene {
+    const char* name;
+    const char* description;
+    uint32_t steps;          // timed steps unless overridden on the command line
+    void (*build)(Scene& scene, PhysicsWorld& world);
+};
+
+const std::vector<BenchScene>& getBenchScenes();
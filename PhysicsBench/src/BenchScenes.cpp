@@ -0,0 +1,256 @@
+#include "BenchScenes.hpp"
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace {
+
+constexpr uint32_t kSeed = 1234;
+constexpr float kFloorHeight = -5.0f;
+
+entt::entity createBody(entt::registry& reg, const glm::vec3& position, ColliderType type, const glm::vec3& size, bool isKinematic = false)
+{
+    entt::entity entity = reg.create();
+    reg.emplace<Transform>(entity, position);
+
+    RigidBodyDesc body;
+    body.position = position;
+    body.isKinematic = isKinematic;
+    body.useGravity = !isKinematic;
+    reg.emplace<RigidBody>(entity, body);
+
+    ColliderDesc collider;
+    collider.type = type;
+    collider.size = size;
+    reg.emplace<Collider>(entity, collider);
+    return entity;
+}
+
+// 32 x 32 columns of four boxes resting on the floor, mostly sleeping after a few steps
+void buildGrid(Scene& scene, PhysicsWorld& world)
+{
+    entt::registry& reg = scene.GetRegistry();
+    for (int x = 0; x < 32; ++x) {
+        for (int z = 0; z < 32; ++z) {
+            for (int y = 0; y < 4; ++y) {
+                createBody(reg, glm::vec3(x * 1.1f, kFloorHeight + y, z * 1.1f), ColliderType::Box, glm::vec3(1.0f));
+            }
+        }
+    }
+}
+
+// Mixed shapes dropped into one column, lots of short lived contacts
+void buildPile(Scene& scene, PhysicsWorld& world)
+{
+    entt::registry& reg = scene.GetRegistry();
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+
+    const ColliderType types[] = { ColliderType::Box, ColliderType::Sphere, ColliderType::Capsule };
+    const glm::vec3 sizes[] = { glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(0.8f, 2.0f, 0.8f) };
+
+    for (int i = 0; i < 4000; ++i) {
+        glm::vec3 position(jitter(rng), kFloorHeight + 1.0f + i * 0.25f, jitter(rng));
+        createBody(reg, position, types[i % 3], sizes[i % 3]);
+    }
+}
+
+// A wall of kinematic boxes under fire from fast swept bullets
+void buildBullets(Scene& scene, PhysicsWorld& world)
+{
+    entt::registry& reg = scene.GetRegistry();
+    for (int x = 0; x < 50; ++x) {
+        for (int y = 0; y < 20; ++y) {
+            createBody(reg, glm::vec3(x * 1.0f - 25.0f, kFloorHeight + y, 40.0f), ColliderType::Box, glm::vec3(1.0f), true);
+        }
+    }
+
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spreadX(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> spreadY(0.0f, 20.0f);
+    std::uniform_real_distribution<float> spreadZ(-200.0f, 0.0f);
+
+    // Outlive the run, so misses keep sweeping like before
+    ProjectilePool& projectiles = scene.GetProjectiles();
+    projectiles.setCapacity(5000);
+    for (int i = 0; i < 5000; ++i) {
+        ProjectileDesc bullet;
+        bullet.position = glm::vec3(spreadX(rng), kFloorHeight + spreadY(rng), spreadZ(rng));
+        bullet.velocity = glm::vec3(0.0f, 0.0f, 300.0f);
+        bullet.lifetime = 60.0f;
+        projectiles.spawn(bullet);
+    }
+}
+
+// 2000 bodies dropped onto a terraced level of 16k static tiles. The tiles
+// touch each other but never pair, and only the falling bodies reinsert.
+void buildLevel(Scene& scene, PhysicsWorld& world)
+{
+    entt::registry& reg = scene.GetRegistry();
+    for (int x = 0; x < 128; ++x) {
+        for (int z = 0; z < 128; ++z) {
+            float terrace = static_cast<float>((x / 16 + z / 16) % 4) * 0.5f;
+            glm::vec3 position(x - 64.0f, kFloorHeight + 2.0f + terrace, z - 64.0f);
+            entt::entity tile = createBody(reg, position, ColliderType::Box, glm::vec3(1.0f));
+
+            RigidBody& body = reg.get<RigidBody>(tile);
+            body.isStatic = true;
+            body.useGravity = false;
+        }
+    }
+
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spread(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> height(2.0f, 30.0f);
+
+    const ColliderType types[] = { ColliderType::Box, ColliderType::Sphere, ColliderType::Capsule };
+    const glm::vec3 sizes[] = { glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(0.8f, 2.0f, 0.8f) };
+
+    for (int i = 0; i < 2000; ++i) {
+        glm::vec3 position(spread(rng), kFloorHeight + 4.0f + height(rng), spread(rng));
+        createBody(reg, position, types[i % 3], sizes[i % 3]);
+    }
+}
+
+// Sizes spread over three orders of magnitude: a few huge kinematic slabs
+// with small and medium bodies raining onto them
+void buildMixed(Scene& scene, PhysicsWorld& world)
+{
+    entt::registry& reg = scene.GetRegistry();
+    for (int x = 0; x < 4; ++x) {
+        for (int z = 0; z < 4; ++z) {
+            glm::vec3 position(x * 40.0f - 60.0f, kFloorHeight + 2.0f, z * 40.0f - 60.0f);
+            createBody(reg, position, ColliderType::Box, glm::vec3(36.0f, 1.0f, 36.0f), true);
+        }
+    }
+
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spread(-75.0f, 75.0f);
+    std::uniform_real_distribution<float> height(4.0f, 40.0f);
+
+    for (int i = 0; i < 4000; ++i) {
+        glm::vec3 position(spread(rng), kFloorHeight + height(rng), spread(rng));
+        if (i % 10 == 0) {
+            createBody(reg, position, ColliderType::Box, glm::vec3(3.0f));
+        }
+        else {
+            createBody(reg, position, ColliderType::Sphere, glm::vec3(0.25f));
+        }
+    }
+}
+
+// 3000 bodies rolling down procedural hills, ground contacts come from the
+// heightfield instead of broadphase pairs
+void buildTerrain(Scene& scene, PhysicsWorld& world)
+{
+    constexpr uint32_t kSamples = 257;
+    std::vector<float> heights(kSamples * kSamples);
+    for (uint32_t z = 0; z < kSamples; ++z) {
+        for (uint32_t x = 0; x < kSamples; ++x) {
+            heights[z * kSamples + x] = 4.0f + 3.0f * std::sin(x * 0.07f) * std::cos(z * 0.05f) + std::sin((x + z) * 0.21f);
+        }
+    }
+
+    HeightfieldDesc desc;
+    desc.origin = glm::vec3(-128.0f, kFloorHeight, -128.0f);
+    world.setHeightfield(std::make_shared<Heightfield>(kSamples, kSamples, std::move(heights), desc));
+
+    entt::registry& reg = scene.GetRegistry();
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spread(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> height(12.0f, 30.0f);
+
+    const ColliderType types[] = { ColliderType::Box, ColliderType::Sphere, ColliderType::Capsule };
+    const glm::vec3 sizes[] = { glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(0.8f, 2.0f, 0.8f) };
+
+    for (int i = 0; i < 3000; ++i) {
+        glm::vec3 position(spread(rng), kFloorHeight + height(rng), spread(rng));
+        createBody(reg, position, types[i % 3], sizes[i % 3]);
+    }
+}
+
+// 2000 bodies dropped into a bowl of 32k triangles on one static mesh collider
+void buildMesh(Scene& scene, PhysicsWorld& world)
+{
+    constexpr int kQuads = 128;
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    for (int z = 0; z <= kQuads; ++z) {
+        for (int x = 0; x <= kQuads; ++x) {
+            float fx = x - kQuads * 0.5f;
+            float fz = z - kQuads * 0.5f;
+            vertices.push_back(glm::vec3(fx, (fx * fx + fz * fz) * 0.002f + 0.5f * std::sin(fx * 0.4f), fz));
+        }
+    }
+    for (int z = 0; z < kQuads; ++z) {
+        for (int x = 0; x < kQuads; ++x) {
+            uint32_t i = z * (kQuads + 1) + x;
+            indices.insert(indices.end(), { i, i + kQuads + 1, i + 1, i + 1, i + kQuads + 1, i + kQuads + 2 });
+        }
+    }
+
+    entt::registry& reg = scene.GetRegistry();
+    entt::entity ground = createBody(reg, glm::vec3(0.0f, kFloorHeight + 1.0f, 0.0f), ColliderType::Mesh, glm::vec3(1.0f));
+    RigidBody& body = reg.get<RigidBody>(ground);
+    body.isStatic = true;
+    body.useGravity = false;
+
+    // Wait for the build so every run starts from the same state
+    Collider& collider = reg.get<Collider>(ground);
+    collider.mesh = world.buildTriangleMesh(std::move(vertices), std::move(indices));
+    collider.mesh.wait();
+
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spread(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> height(12.0f, 40.0f);
+
+    const ColliderType types[] = { ColliderType::Box, ColliderType::Sphere, ColliderType::Capsule };
+    const glm::vec3 sizes[] = { glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(0.8f, 2.0f, 0.8f) };
+
+    for (int i = 0; i < 2000; ++i) {
+        glm::vec3 position(spread(rng), kFloorHeight + height(rng), spread(rng));
+        createBody(reg, position, types[i % 3], sizes[i % 3]);
+    }
+}
+
+// 100k small bodies drifting through a huge volume, owned by the world
+// instead of the registry. Few pairs, stresses the per-body paths.
+void buildSparse(Scene& scene, PhysicsWorld& world)
+{
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> spread(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> drift(-1.0f, 1.0f);
+
+    ColliderDesc collider;
+    collider.type = ColliderType::Sphere;
+    collider.size = glm::vec3(1.0f);
+
+    for (int i = 0; i < 100000; ++i) {
+        RigidBodyDesc desc;
+        desc.position = glm::vec3(spread(rng), spread(rng) + 1000.0f, spread(rng));
+        desc.velocity = glm::vec3(drift(rng), drift(rng), drift(rng));
+        desc.useGravity = false;
+
+        RigidBodyID body = world.createRigidBody(desc);
+        world.attachCollider(body, world.createCollider(collider));
+    }
+}
+
+} // namespace
+
+const std::vector<BenchScene>& getBenchScenes()
+{
+    static const std::vector<BenchScene> scenes = {
+        { "grid",    "4096 boxes stacked in a grid",          300, &buildGrid },
+        { "pile",    "4000 mixed shapes falling into a pile", 600, &buildPile },
+        { "bullets", "5000 swept bullets against 1000 boxes", 300, &buildBullets },
+        { "sparse",  "100k world owned spheres, few pairs",   100, &buildSparse },
+        { "level",   "2000 bodies on 16k static tiles",       300, &buildLevel },
+        { "mixed",   "4000 bodies of very different sizes",   300, &buildMixed },
+        { "terrain", "3000 bodies on a 257 x 257 heightfield", 300, &buildTerrain },
+        { "mesh",    "2000 bodies in a 32k triangle bowl",    300, &buildMesh },
+    };
+    return scenes;
+}
@@ -0,0 +1,223 @@
+#include "BenchScenes.hpp"
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+using json = nlohmann::ordered_json;
+
+namespace {
+
+struct BenchOptions {
+    std::vector<std::string> scenes;  // empty runs all
+    uint32_t steps = 0;               // 0 keeps each scene's default
+    uint32_t warmupSteps = 10;
+    uint32_t threads = 0;             // 0 uses every hardware thread
+    BroadphaseType broadphase = BroadphaseType::DynamicTree;
+    std::string outputPath;           // empty writes to stdout
+    bool timeSnapshots = true;
+};
+
+void printUsage()
+{
+    std::fprintf(stderr,
+        "Usage: PhysicsBench [options]\n"
+        "  --scene <name>        run only this scene, may repeat (default: all)\n"
+        "  --steps <n>           timed steps per scene\n"
+        "  --warmup <n>          untimed steps before measuring (default: 10)\n"
+        "  --threads <n>         physics threads, 0 for all cores (default: 0)\n"
+        "  --broadphase <type>   tree, sap or grid (default: tree)\n"
+        "  --out <file>          write JSON to a file instead of stdout\n"
+        "  --no-snapshot         skip the snapshot capture/restore timings\n"
+        "  --list                print the scenes and exit\n");
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+            };
+
+        const char* value = nullptr;
+        if (arg == "--scene" && (value = next())) {
+            options.scenes.push_back(value);
+        }
+        else if (arg == "--steps" && (value = next())) {
+            options.steps = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (arg == "--warmup" && (value = next())) {
+            options.warmupSteps = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (arg == "--threads" && (value = next())) {
+            options.threads = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (arg == "--broadphase" && (value = next())) {
+            if (std::strcmp(value, "tree") == 0) options.broadphase = BroadphaseType::DynamicTree;
+            else if (std::strcmp(value, "sap") == 0) options.broadphase = BroadphaseType::SweepAndPrune;
+            else if (std::strcmp(value, "grid") == 0) options.broadphase = BroadphaseType::HierarchicalGrid;
+            else return false;
+        }
+        else if (arg == "--out" && (value = next())) {
+            options.outputPath = value;
+        }
+        else if (arg == "--no-snapshot") {
+            options.timeSnapshots = false;
+        }
+        else if (arg == "--list") {
+            for (const BenchScene& scene : getBenchScenes()) {
+                std::printf("%-10s %s\n", scene.name, scene.description);
+            }
+            std::exit(0);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mean, percentiles and extremes of a sample set
+json summarize(std::vector<double> samples)
+{
+    if (samples.empty()) return json::object();
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        return samples[static_cast<size_t>(p * (samples.size() - 1))];
+        };
+
+    json result;
+    result["mean"] = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    result["median"] = percentile(0.5);
+    result["p95"] = percentile(0.95);
+    result["min"] = samples.front();
+    result["max"] = samples.back();
+    return result;
+}
+
+double elapsedMicroseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// Times a capture and a restore of the state the timed steps ended in.
+// Restoring it again leaves the world unchanged. PhysicsTests checks that
+// a restore replays bit for bit.
+json timeSnapshot(PhysicsWorld& world)
+{
+    PhysicsWorld::Snapshot snapshot;
+
+    auto captureStart = std::chrono::steady_clock::now();
+    world.captureSnapshot(snapshot);
+    auto captureEnd = std::chrono::steady_clock::now();
+
+    auto restoreStart = std::chrono::steady_clock::now();
+    world.restoreSnapshot(snapshot);
+    auto restoreEnd = std::chrono::steady_clock::now();
+
+    json result;
+    result["snapshotBytes"] = snapshot.getMemoryUsage();
+    result["captureUs"] = elapsedMicroseconds(captureStart, captureEnd);
+    result["restoreUs"] = elapsedMicroseconds(restoreStart, restoreEnd);
+    return result;
+}
+
+json runScene(const BenchScene& bench, const BenchOptions& options)
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(options.threads);
+    world.setBroadphaseType(options.broadphase);
+    bench.build(scene, world);
+
+    const float dt = 1.0f / 60.0f;
+    for (uint32_t i = 0; i < options.warmupSteps; ++i) {
+        world.stepSimulation(dt);
+    }
+
+    uint32_t steps = options.steps ? options.steps : bench.steps;
+    std::vector<double> stepTimes;
+    std::vector<double> pairCounts;
+    std::vector<double> contactCounts;
+    stepTimes.reserve(steps);
+    pairCounts.reserve(steps);
+    contactCounts.reserve(steps);
+
+    for (uint32_t i = 0; i < steps; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        world.stepSimulation(dt);
+        auto end = std::chrono::steady_clock::now();
+
+        stepTimes.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        pairCounts.push_back(static_cast<double>(world.getPairCount()));
+        contactCounts.push_back(static_cast<double>(world.getContactCount()));
+    }
+
+    json result;
+    result["name"] = bench.name;
+    result["description"] = bench.description;
+    result["bodies"] = world.getBodyCount();
+    result["awakeBodies"] = world.getAwakeBodyCount();
+    result["warmupSteps"] = options.warmupSteps;
+    result["steps"] = steps;
+    result["nsPerStep"] = summarize(std::move(stepTimes));
+    result["pairs"] = summarize(std::move(pairCounts));
+    result["contacts"] = summarize(std::move(contactCounts));
+    result["memoryBytes"] = world.getMemoryUsage();
+    if (options.timeSnapshots) {
+        result["snapshot"] = timeSnapshot(world);
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    json report;
+    report["threads"] = options.threads;
+    const char* broadphaseNames[] = { "tree", "sap", "grid" };
+    report["broadphase"] = broadphaseNames[static_cast<size_t>(options.broadphase)];
+
+    json scenes = json::array();
+    for (const BenchScene& bench : getBenchScenes()) {
+        if (!options.scenes.empty() &&
+            std::find(options.scenes.begin(), options.scenes.end(), bench.name) == options.scenes.end()) {
+            continue;
+        }
+
+        std::fprintf(stderr, "[PhysicsBench] %s: %s\n", bench.name, bench.description);
+        scenes.push_back(runScene(bench, options));
+    }
+    report["scenes"] = scenes;
+
+    if (options.outputPath.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    }
+    else {
+        std::ofstream file(options.outputPath);
+        if (!file) {
+            std::fprintf(stderr, "[PhysicsBench] Could not open %s\n", options.outputPath.c_str());
+            return 1;
+        }
+        file << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <AABBBatch.hpp>
+#include <HierarchicalGrid.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct BoxGenerator {
+    std::mt19937 rng{ 7 };
+    std::uniform_real_distribution<float> value{ -10.0f, 10.0f };
+    std::uniform_real_distribution<float> extent{ 0.1f, 2.0f };
+
+    AABB operator()() {
+        glm::vec3 center(value(rng), value(rng), value(rng));
+        return AABB::fromCenterExtents(center, glm::vec3(extent(rng), extent(rng), extent(rng)));
+    }
+};
+
+} // namespace
+
+TEST_CASE("SIMD overlap masks match the scalar kernel and AABB::overlaps", "[AABBBatch]")
+{
+    // 1003 leaves a partial last block of three live lanes
+    for (size_t count : { size_t(3), size_t(8), size_t(1003) }) {
+        BoxGenerator randomBox;
+        AABBBatch batch;
+        for (size_t i = 0; i < count; ++i) {
+            batch.add(randomBox());
+        }
+
+        for (size_t q = 0; q < 200; ++q) {
+            // Every few queries reuse a stored box so touching faces get tested
+            AABB query = q % 4 == 0 ? batch.get(q % count) : randomBox();
+
+            for (size_t begin = 0; begin < count; begin += kSimdWidth) {
+                uint32_t simd = batch.overlapMask(query, begin);
+                REQUIRE(simd == batch.overlapMaskScalar(query, begin));
+
+                uint32_t expected = 0;
+                for (size_t lane = 0; lane < kSimdWidth && begin + lane < count; ++lane) {
+                    if (batch.get(begin + lane).overlaps(query)) expected |= 1u << lane;
+                }
+                REQUIRE(simd == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Removed boxes and padding lanes never overlap", "[AABBBatch]")
+{
+    AABBBatch batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.add(AABB::fromCenterExtents(glm::vec3(static_cast<float>(i), 0.0f, 0.0f), glm::vec3(0.25f)));
+    }
+    batch.removeSwap(2);
+    batch.removeSwap(batch.size() - 1);
+    REQUIRE(batch.size() == 8);
+
+    // Box 9 moved into slot 2, box 8 was dropped
+    CHECK(batch.get(2).getCenter().x == 9.0f);
+
+    std::vector<size_t> hits;
+    AABB everything(glm::vec3(-1e30f), glm::vec3(1e30f));
+    batch.query(everything, [&](size_t index) { hits.push_back(index); return true; });
+    CHECK(hits.size() == 8);
+
+    hits.clear();
+    batch.query(AABB::fromCenterExtents(glm::vec3(8.0f, 0.0f, 0.0f), glm::vec3(0.1f)), [&](size_t index) {
+        hits.push_back(index);
+        return true;
+        });
+    CHECK(hits.empty());
+}
+
+TEST_CASE("Grid queries report every overlapping proxy once", "[AABBBatch]")
+{
+    BoxGenerator randomBox;
+    std::vector<AABB> boxes;
+    HierarchicalGrid grid;
+    for (int32_t id = 0; id < 300; ++id) {
+        boxes.push_back(randomBox());
+        grid.addProxy(id, boxes.back());
+    }
+    grid.updateLevels();
+
+    // Move some proxies so cells see swap-removes
+    for (int32_t id = 0; id < 300; id += 3) {
+        boxes[id] = randomBox();
+        grid.updateProxy(id, boxes[id]);
+    }
+
+    for (int q = 0; q < 50; ++q) {
+        AABB query = randomBox();
+        std::vector<int32_t> found;
+        grid.query(query, [&](int32_t id) { found.push_back(id); return true; });
+        std::sort(found.begin(), found.end());
+
+        std::vector<int32_t> expected;
+        for (int32_t id = 0; id < 300; ++id) {
+            if (boxes[id].overlaps(query)) expected.push_back(id);
+        }
+        REQUIRE(found == expected);
+    }
+}
@@ -0,0 +1,88 @@
+#include <BodyStore.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace {
+
+// Random bodies with every kinematic/gravity combination, added to both stores
+void fillStores(BodyStore& simd, BodyStore& scalar, size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 position(value(rng), value(rng), value(rng));
+        glm::vec3 velocity(value(rng), value(rng), value(rng));
+        float mass = 1.0f + std::abs(value(rng));
+        bool isKinematic = i % 7 == 0;
+        bool useGravity = i % 5 != 0;
+        simd.add(position, velocity, mass, isKinematic, useGravity);
+        scalar.add(position, velocity, mass, isKinematic, useGravity);
+    }
+}
+
+bool sameBits(const AlignedFloats& a, const AlignedFloats& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("SIMD integration matches the scalar reference bit for bit", "[BodyStore]")
+{
+    // Full blocks only, and a partial last block whose padding lanes still run through the kernels
+    for (size_t count : { size_t(1), size_t(7), size_t(64), size_t(1003) }) {
+        BodyStore simd;
+        BodyStore scalar;
+        fillStores(simd, scalar, count);
+
+        for (int step = 0; step < 120; ++step) {
+            simd.integrate(1.0f / 60.0f, -9.81f, -5.0f);
+            scalar.integrateScalar(1.0f / 60.0f, -9.81f, -5.0f);
+        }
+
+        INFO("bodies: " << count);
+        CHECK(simd.px.size() % kSimdWidth == 0);
+        CHECK(sameBits(simd.px, scalar.px));
+        CHECK(sameBits(simd.py, scalar.py));
+        CHECK(sameBits(simd.pz, scalar.pz));
+        CHECK(sameBits(simd.vx, scalar.vx));
+        CHECK(sameBits(simd.vy, scalar.vy));
+        CHECK(sameBits(simd.vz, scalar.vz));
+    }
+}
+
+TEST_CASE("Padding lanes stay at rest", "[BodyStore]")
+{
+    BodyStore store;
+    BodyStore unused;
+    fillStores(store, unused, 5);
+
+    for (int step = 0; step < 10; ++step) {
+        store.integrate(1.0f / 60.0f, -9.81f, 100.0f);
+    }
+
+    // The floor clamp moves padding positions up, but gravity never reaches them
+    for (size_t i = store.size(); i < store.px.size(); ++i) {
+        CHECK(store.vx[i] == 0.0f);
+        CHECK(store.vy[i] == 0.0f);
+        CHECK(store.vz[i] == 0.0f);
+    }
+}
+
+TEST_CASE("Kinematic bodies and bodies without gravity keep their velocity", "[BodyStore]")
+{
+    BodyStore store;
+    size_t kinematic = store.add(glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f), 1.0f, true, true);
+    size_t floating = store.add(glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f), 1.0f, false, false);
+    size_t falling = store.add(glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f), 1.0f, false, true);
+
+    store.integrateVelocities(0.5f, -10.0f);
+
+    CHECK(store.getVelocity(kinematic).y == 2.0f);
+    CHECK(store.getVelocity(floating).y == 2.0f);
+    CHECK(store.getVelocity(falling).y == -3.0f);
+    CHECK(store.invMass[kinematic] == 0.0f);
+}
@@ -0,0 +1,69 @@
+#include <Narrowphase.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <random>
+
+TEST_CASE("Separated box and capsule report the exact distance", "[Narrowphase]")
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> extent(0.2f, 1.5f);
+
+    for (int i = 0; i < 500; ++i) {
+        ShapeInstance box;
+        box.type = ColliderType::Box;
+        box.center = glm::vec3(value(rng), value(rng), value(rng));
+        box.rotation = rotationFromEuler(glm::vec3(angle(rng), angle(rng), angle(rng)));
+        box.halfExtents = glm::vec3(extent(rng), extent(rng), extent(rng));
+
+        ShapeInstance capsule;
+        capsule.type = ColliderType::Capsule;
+        capsule.center = glm::vec3(value(rng), value(rng), value(rng));
+        capsule.rotation = rotationFromEuler(glm::vec3(angle(rng), angle(rng), angle(rng)));
+        capsule.radius = 0.05f;
+        capsule.halfHeight = extent(rng);
+
+        // Densely sampled spheres along the segment bound the distance from above
+        float sampled = FLT_MAX;
+        for (int s = 0; s <= 2000; ++s) {
+            ShapeInstance sphere;
+            sphere.type = ColliderType::Sphere;
+            sphere.center = capsule.getSegmentA() + (capsule.getSegmentB() - capsule.getSegmentA()) * (s / 2000.0f);
+            sphere.radius = capsule.radius;
+            ContactManifold contact;
+            if (collideShapes(box, sphere, FLT_MAX, contact)) {
+                sampled = std::min(sampled, contact.separation);
+            }
+        }
+        if (sampled <= 0.0f) continue;
+
+        ContactManifold contact;
+        REQUIRE(collideShapes(box, capsule, FLT_MAX, contact));
+        INFO("pair " << i);
+        CHECK(contact.separation <= sampled + 1e-4f);
+        CHECK(contact.separation >= sampled - 1e-2f);
+    }
+}
+
+TEST_CASE("A capsule through a box is pushed out from its deepest point", "[Narrowphase]")
+{
+    ShapeInstance box;
+    box.type = ColliderType::Box;
+    box.halfExtents = glm::vec3(4.0f, 0.5f, 4.0f);
+
+    // Lies across the top face, dipping 0.3 into the box at its low end
+    ShapeInstance capsule;
+    capsule.type = ColliderType::Capsule;
+    capsule.radius = 0.1f;
+    capsule.halfHeight = 1.0f;
+    capsule.center = glm::vec3(1.0f, 0.5f, 0.0f);
+    capsule.rotation = rotationFromEuler(glm::vec3(0.0f, 0.0f, 72.5423f));
+
+    ContactManifold contact;
+    REQUIRE(collideShapes(box, capsule, 0.0f, contact));
+    CHECK(contact.normal.y > 0.99f);
+    CHECK(contact.separation < -0.35f);
+    CHECK(contact.separation > -0.45f);
+}
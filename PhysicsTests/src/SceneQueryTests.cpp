@@ -0,0 +1,152 @@
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr float kDt = 1.0f / 60.0f;
+
+// Floats in place so queries see the same poses the step left behind
+entt::entity addShape(Scene& scene, ColliderType type, const glm::vec3& position, const glm::vec3& rotation, bool isStatic)
+{
+    entt::registry& reg = scene.GetRegistry();
+    entt::entity entity = reg.create();
+    reg.emplace<Transform>(entity, position, rotation);
+    RigidBodyDesc desc;
+    desc.position = position;
+    desc.useGravity = false;
+    desc.isStatic = isStatic;
+    reg.emplace<RigidBody>(entity, desc).rotation = rotation;
+    ColliderDesc collider;
+    collider.type = type;
+    collider.size = type == ColliderType::Box ? glm::vec3(1.4f, 0.6f, 1.0f) : glm::vec3(1.0f, 2.0f, 1.0f);
+    reg.emplace<Collider>(entity, collider);
+    return entity;
+}
+
+bool contains(const std::vector<entt::entity>& entities, entt::entity entity)
+{
+    return std::find(entities.begin(), entities.end(), entity) != entities.end();
+}
+
+} // namespace
+
+TEST_CASE("Batched rays hit what single rays hit", "[SceneQuery]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+
+    // Rotated boxes, spheres and capsules on a grid, every other one static
+    std::vector<entt::entity> staticBodies;
+    std::vector<entt::entity> dynamicBodies;
+    int index = 0;
+    for (int x = 0; x < 4; ++x) {
+        for (int z = 0; z < 4; ++z) {
+            ColliderType type = static_cast<ColliderType>(index % 3);
+            bool isStatic = index % 2 == 0;
+            glm::vec3 position(3.0f * x, 2.0f + 0.5f * (index % 3), 3.0f * z);
+            entt::entity entity = addShape(scene, type, position, glm::vec3(17.0f * index, 31.0f * index, 5.0f * index), isStatic);
+            (isStatic ? staticBodies : dynamicBodies).push_back(entity);
+            ++index;
+        }
+    }
+    world.stepSimulation(kDt);
+
+    // Aimed into the grid so most rays hit something
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> across(-2.0f, 11.0f);
+    std::uniform_real_distribution<float> height(0.0f, 5.0f);
+    // The last packet is only partly filled
+    std::vector<Ray> rays(301);
+    REQUIRE(rays.size() % kRayPacketSize != 0);
+    for (Ray& ray : rays) {
+        ray.origin = glm::vec3(across(rng), height(rng) + 4.0f, across(rng));
+        glm::vec3 target(across(rng), height(rng), across(rng));
+        ray.direction = glm::normalize(target - ray.origin);
+        ray.maxDistance = 30.0f;
+    }
+
+    std::vector<RaycastHit> hits(rays.size());
+    world.raycastBatch(rays.data(), rays.size(), hits.data());
+
+    size_t staticHits = 0;
+    size_t dynamicHits = 0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        RaycastHit single;
+        world.raycast(rays[i], single);
+
+        INFO("ray " << i);
+        REQUIRE(hits[i].hasHit() == single.hasHit());
+        if (!single.hasHit()) continue;
+        CHECK(hits[i].body == single.body);
+        CHECK(std::abs(hits[i].distance - single.distance) < 1e-4f);
+
+        staticHits += contains(staticBodies, single.body);
+        dynamicHits += contains(dynamicBodies, single.body);
+    }
+
+    // Both trees took part
+    CHECK(staticHits > 0);
+    CHECK(dynamicHits > 0);
+}
+
+TEST_CASE("Rays pass beside a sphere inside its box", "[SceneQuery]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+    addShape(scene, ColliderType::Sphere, glm::vec3(0.0f), glm::vec3(0.0f), false);
+    world.stepSimulation(kDt);
+
+    // Through the corner of the bounding box, well clear of the sphere
+    Ray ray;
+    ray.origin = glm::vec3(0.45f, 0.45f, 5.0f);
+    ray.direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    RaycastHit hit;
+    CHECK_FALSE(world.raycast(ray, hit));
+    world.raycastBatch(&ray, 1, &hit);
+    CHECK_FALSE(hit.hasHit());
+    CHECK(hit.body == entt::null);
+
+    // Straight through the middle meets the surface
+    ray.origin = glm::vec3(0.0f, 0.0f, 5.0f);
+    REQUIRE(world.raycast(ray, hit));
+    CHECK(std::abs(hit.distance - 4.5f) < 1e-4f);
+    CHECK(hit.normal.z > 0.999f);
+}
+
+TEST_CASE("Overlap queries report static and dynamic bodies", "[SceneQuery]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+
+    entt::entity wall = addShape(scene, ColliderType::Box, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f), true);
+    entt::entity ball = addShape(scene, ColliderType::Sphere, glm::vec3(1.5f, 0.0f, 0.0f), glm::vec3(0.0f), false);
+    entt::entity far = addShape(scene, ColliderType::Capsule, glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(0.0f), false);
+    world.stepSimulation(kDt);
+
+    ColliderDesc query;
+    query.type = ColliderType::Sphere;
+    query.size = glm::vec3(1.0f);
+    Transform pose;
+    pose.position = glm::vec3(0.9f, 0.0f, 0.0f);
+
+    std::vector<entt::entity> results;
+    world.overlapQuery(query, pose, results);
+    CHECK(results.size() == 2);
+    CHECK(contains(results, wall));
+    CHECK(contains(results, ball));
+    CHECK_FALSE(contains(results, far));
+
+    // Only the static wall is left in reach
+    pose.position = glm::vec3(-0.9f, 0.0f, 0.0f);
+    world.overlapQuery(query, pose, results);
+    REQUIRE(results.size() == 1);
+    CHECK(results[0] == wall);
+}
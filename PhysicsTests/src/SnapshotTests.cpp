@@ -0,0 +1,177 @@
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr float kDt = 1.0f / 60.0f;
+
+entt::entity addBox(Scene& scene, const glm::vec3& position, const glm::vec3& velocity = glm::vec3(0.0f))
+{
+    entt::registry& reg = scene.GetRegistry();
+    entt::entity entity = reg.create();
+    reg.emplace<Transform>(entity, position);
+    RigidBodyDesc desc;
+    desc.position = position;
+    desc.velocity = velocity;
+    reg.emplace<RigidBody>(entity, desc);
+    ColliderDesc collider;
+    collider.size = glm::vec3(1.0f);
+    reg.emplace<Collider>(entity, collider);
+    return entity;
+}
+
+void stepUntilAsleep(PhysicsWorld& world)
+{
+    for (int i = 0; i < 600 && world.getAwakeBodyCount() > 0; ++i) {
+        world.stepSimulation(kDt);
+    }
+}
+
+bool sameBytes(const void* a, const void* b, size_t size)
+{
+    return std::memcmp(a, b, size) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Restoring a snapshot replays the same steps bit for bit", "[Snapshot]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+
+    // A settling stack, boxes falling onto it and projectiles in flight
+    for (int y = 0; y < 4; ++y) {
+        addBox(scene, glm::vec3(0.0f, -4.5f + y, 0.0f));
+    }
+    for (int i = 0; i < 6; ++i) {
+        addBox(scene, glm::vec3(0.3f * i - 0.75f, 2.0f + 1.5f * i, 0.1f * i), glm::vec3(0.0f, -1.0f, 0.5f));
+    }
+    for (int i = 0; i < 4; ++i) {
+        ProjectileDesc projectile;
+        projectile.position = glm::vec3(-6.0f, -3.0f + i, 0.0f);
+        projectile.velocity = glm::vec3(20.0f, 0.0f, 0.0f);
+        scene.GetProjectiles().spawn(projectile);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        world.stepSimulation(kDt);
+    }
+
+    PhysicsWorld::Snapshot start;
+    PhysicsWorld::Snapshot first;
+    PhysicsWorld::Snapshot second;
+    world.captureSnapshot(start);
+    for (int i = 0; i < 30; ++i) {
+        world.stepSimulation(kDt);
+    }
+    world.captureSnapshot(first);
+
+    world.restoreSnapshot(start);
+    for (int i = 0; i < 30; ++i) {
+        world.stepSimulation(kDt);
+    }
+    world.captureSnapshot(second);
+
+    REQUIRE(first.bodies.size() == second.bodies.size());
+    for (size_t i = 0; i < first.bodies.size(); ++i) {
+        const RigidBody& a = first.bodies[i].body;
+        const RigidBody& b = second.bodies[i].body;
+        INFO("body " << i);
+        CHECK(first.bodies[i].entity == second.bodies[i].entity);
+        CHECK(sameBytes(&a.position, &b.position, sizeof(glm::vec3)));
+        CHECK(sameBytes(&a.velocity, &b.velocity, sizeof(glm::vec3)));
+        CHECK(a.isSleeping == b.isSleeping);
+    }
+
+    REQUIRE(first.manifolds.size() == second.manifolds.size());
+    for (size_t i = 0; i < first.manifolds.size(); ++i) {
+        const ContactManifold& a = first.manifolds[i];
+        const ContactManifold& b = second.manifolds[i];
+        INFO("manifold " << i);
+        CHECK(a.pairId == b.pairId);
+        CHECK(sameBytes(&a.normalImpulse, &b.normalImpulse, sizeof(float)));
+        CHECK(sameBytes(a.tangentImpulse, b.tangentImpulse, sizeof(a.tangentImpulse)));
+    }
+
+    REQUIRE(first.projectiles.size() == second.projectiles.size());
+    for (size_t i = 0; i < first.projectiles.size(); ++i) {
+        INFO("projectile " << i);
+        CHECK(sameBytes(&first.projectiles[i], &second.projectiles[i], sizeof(ProjectileDesc)));
+    }
+}
+
+TEST_CASE("Bodies created after the capture are woken by a restore", "[Snapshot]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+    entt::registry& reg = scene.GetRegistry();
+
+    entt::entity old = addBox(scene, glm::vec3(0.0f, -4.5f, 0.0f));
+    stepUntilAsleep(world);
+    REQUIRE(reg.get<RigidBody>(old).isSleeping);
+
+    PhysicsWorld::Snapshot snapshot;
+    world.captureSnapshot(snapshot);
+
+    // Falls asleep in an island the snapshot doesn't know about
+    entt::entity late = addBox(scene, glm::vec3(10.0f, -4.5f, 0.0f));
+    stepUntilAsleep(world);
+    REQUIRE(reg.get<RigidBody>(late).isSleeping);
+    REQUIRE(reg.get<RigidBody>(late).islandId != -1);
+
+    world.restoreSnapshot(snapshot);
+
+    const RigidBody& lateBody = reg.get<RigidBody>(late);
+    CHECK_FALSE(lateBody.isSleeping);
+    CHECK(lateBody.islandId == -1);
+    CHECK(reg.get<RigidBody>(old).isSleeping);
+
+    // Settles and sleeps again in an island of its own
+    stepUntilAsleep(world);
+    CHECK(world.getAwakeBodyCount() == 0);
+    CHECK(reg.get<RigidBody>(late).islandId != reg.get<RigidBody>(old).islandId);
+}
+
+TEST_CASE("Contacts of bodies destroyed after the capture are dropped", "[Snapshot]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+    entt::registry& reg = scene.GetRegistry();
+
+    entt::entity bottom = addBox(scene, glm::vec3(0.0f, -4.5f, 0.0f));
+    entt::entity top = addBox(scene, glm::vec3(0.0f, -3.5f, 0.0f));
+    for (int i = 0; i < 30; ++i) {
+        world.stepSimulation(kDt);
+    }
+
+    PhysicsWorld::Snapshot snapshot;
+    world.captureSnapshot(snapshot);
+    const uint32_t topId = static_cast<uint32_t>(top);
+    auto namesTop = [&](const PhysicsWorld::Snapshot& s) {
+        for (const ContactManifold& m : s.manifolds) {
+            if (m.entityA == topId || m.entityB == topId) return true;
+        }
+        return false;
+        };
+    REQUIRE(namesTop(snapshot));
+
+    reg.destroy(top);
+    world.restoreSnapshot(snapshot);
+
+    PhysicsWorld::Snapshot restored;
+    world.captureSnapshot(restored);
+    CHECK_FALSE(namesTop(restored));
+    CHECK(restored.bodies.size() == 1);
+
+    // The bottom box keeps its ground contact and carries on
+    CHECK_FALSE(restored.manifolds.empty());
+    world.stepSimulation(kDt);
+    CHECK(reg.valid(bottom));
+}
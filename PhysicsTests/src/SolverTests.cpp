@@ -0,0 +1,203 @@
+#include <ConstraintSolver.hpp>
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr float kDt = 1.0f / 60.0f;
+
+ContactManifold makeManifold(uint64_t pairId, int32_t bodyA, int32_t bodyB)
+{
+    ContactManifold m;
+    m.pairId = pairId;
+    m.bodyA = bodyA;
+    m.bodyB = bodyB;
+    m.normalImpulse = 1.0f;
+    m.tangentImpulse[0] = 0.25f;
+    m.tangentImpulse[1] = -0.25f;
+    return m;
+}
+
+void addBox(entt::registry& reg, const glm::vec3& position, const glm::vec3& velocity = glm::vec3(0.0f))
+{
+    entt::entity entity = reg.create();
+    reg.emplace<Transform>(entity, position);
+    RigidBodyDesc desc;
+    desc.position = position;
+    desc.velocity = velocity;
+    reg.emplace<RigidBody>(entity, desc);
+    ColliderDesc collider;
+    collider.size = glm::vec3(1.0f);
+    reg.emplace<Collider>(entity, collider);
+}
+
+// Steps a brick pyramid (one island, large enough to be coloured), a few
+// separate stacks and some falling boxes with the given thread count
+void runMixedScene(uint32_t threadCount, PhysicsWorld::Snapshot& result, uint32_t& maxColors)
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(threadCount);
+    entt::registry& reg = scene.GetRegistry();
+
+    // Each brick rests on four below it, so every layer links into one island
+    for (int layer = 0; layer < 5; ++layer) {
+        int side = 8 - layer;
+        float offset = 0.5f * layer;
+        for (int x = 0; x < side; ++x) {
+            for (int z = 0; z < side; ++z) {
+                addBox(reg, glm::vec3(offset + x, -4.5f + layer, offset + z));
+            }
+        }
+    }
+    for (int stack = 0; stack < 3; ++stack) {
+        for (int y = 0; y < 4; ++y) {
+            addBox(reg, glm::vec3(20.0f + 4.0f * stack, -4.5f + y, 0.0f));
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        addBox(reg, glm::vec3(1.0f + i, 3.0f + 1.5f * i, 3.5f), glm::vec3(0.0f, -2.0f, 0.1f * i));
+    }
+
+    maxColors = 0;
+    for (int i = 0; i < 60; ++i) {
+        world.stepSimulation(kDt);
+        maxColors = std::max(maxColors, world.getStats().solverColors);
+    }
+    world.captureSnapshot(result);
+}
+
+} // namespace
+
+TEST_CASE("Manifolds without a moving body keep their warm start impulses", "[ConstraintSolver]")
+{
+    TaskPool pool(1);
+    BodyStore bodies;
+    ConstraintSolver solver;
+
+    std::vector<ContactManifold> manifolds;
+    ContactManifold asleep = makeManifold(1, -1, -1);
+    asleep.asleep = true;
+    manifolds.push_back(asleep);
+    // Just woken, its bodies join the store next step
+    manifolds.push_back(makeManifold(2, -1, -1));
+    ContactManifold trigger = makeManifold(3, -1, -1);
+    trigger.isTrigger = true;
+    manifolds.push_back(trigger);
+
+    solver.solve(manifolds, bodies, kDt, pool);
+
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK(manifolds[i].normalImpulse == 1.0f);
+        CHECK(manifolds[i].tangentImpulse[0] == 0.25f);
+        CHECK(manifolds[i].tangentImpulse[1] == -0.25f);
+    }
+    CHECK(manifolds[2].normalImpulse == 0.0f);
+    CHECK(manifolds[2].tangentImpulse[0] == 0.0f);
+
+    solver.setWarmStarting(false);
+    solver.solve(manifolds, bodies, kDt, pool);
+    CHECK(manifolds[0].normalImpulse == 0.0f);
+}
+
+TEST_CASE("A stack keeps its impulses through sleep and wake", "[ConstraintSolver]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(1);
+    entt::registry& reg = scene.GetRegistry();
+
+    std::vector<entt::entity> boxes;
+    for (int y = 0; y < 3; ++y) {
+        glm::vec3 position(0.0f, -5.0f + y, 0.0f);
+        entt::entity entity = reg.create();
+        reg.emplace<Transform>(entity, position);
+        RigidBodyDesc desc;
+        desc.position = position;
+        reg.emplace<RigidBody>(entity, desc);
+        ColliderDesc collider;
+        collider.size = glm::vec3(1.0f);
+        reg.emplace<Collider>(entity, collider);
+        boxes.push_back(entity);
+    }
+
+    // The box on top presses on the one below
+    auto stackImpulse = [&]() {
+        PhysicsWorld::Snapshot snapshot;
+        world.captureSnapshot(snapshot);
+        float impulse = 0.0f;
+        for (const ContactManifold& m : snapshot.manifolds) {
+            // Ground contacts report UINT32_MAX as entity B
+            if (m.entityB != UINT32_MAX) impulse += m.normalImpulse;
+        }
+        return impulse;
+        };
+
+    int steps = 0;
+    while (world.getAwakeBodyCount() > 0 && steps < 600) {
+        world.stepSimulation(kDt);
+        ++steps;
+    }
+    REQUIRE(world.getAwakeBodyCount() == 0);
+
+    // A few more steps asleep, the cached manifolds must not lose anything
+    float beforeSleep = stackImpulse();
+    REQUIRE(beforeSleep > 0.0f);
+    for (int i = 0; i < 10; ++i) {
+        world.stepSimulation(kDt);
+    }
+    CHECK(stackImpulse() == beforeSleep);
+
+    // A nudge wakes the island, the first awake step starts from those impulses
+    reg.get<RigidBody>(boxes.back()).velocity = glm::vec3(0.0f, 0.0f, 1e-4f);
+    world.stepSimulation(kDt);
+    CHECK(world.getAwakeBodyCount() == boxes.size());
+    CHECK(stackImpulse() > 0.5f * beforeSleep);
+
+    // Warm started, the stack doesn't jump when it wakes
+    for (entt::entity entity : boxes) {
+        CHECK(std::abs(reg.get<RigidBody>(entity).velocity.y) < 0.05f);
+    }
+}
+
+TEST_CASE("Thread count doesn't change the simulation", "[ConstraintSolver]")
+{
+    PhysicsWorld::Snapshot serial;
+    PhysicsWorld::Snapshot threaded;
+    uint32_t serialColors = 0;
+    uint32_t threadedColors = 0;
+    runMixedScene(1, serial, serialColors);
+    runMixedScene(4, threaded, threadedColors);
+
+#if PHYSICS_ENABLE_STATS
+    // Otherwise only the island path would be covered
+    REQUIRE(serialColors > 0);
+    CHECK(threadedColors == serialColors);
+#endif
+
+    REQUIRE(serial.bodies.size() == threaded.bodies.size());
+    for (size_t i = 0; i < serial.bodies.size(); ++i) {
+        const RigidBody& a = serial.bodies[i].body;
+        const RigidBody& b = threaded.bodies[i].body;
+        INFO("body " << i);
+        CHECK(serial.bodies[i].entity == threaded.bodies[i].entity);
+        CHECK(std::memcmp(&a.position, &b.position, sizeof(glm::vec3)) == 0);
+        CHECK(std::memcmp(&a.velocity, &b.velocity, sizeof(glm::vec3)) == 0);
+    }
+
+    REQUIRE(serial.manifolds.size() == threaded.manifolds.size());
+    for (size_t i = 0; i < serial.manifolds.size(); ++i) {
+        const ContactManifold& a = serial.manifolds[i];
+        const ContactManifold& b = threaded.manifolds[i];
+        INFO("manifold " << i);
+        CHECK(a.pairId == b.pairId);
+        CHECK(std::memcmp(&a.normalImpulse, &b.normalImpulse, sizeof(float)) == 0);
+        CHECK(std::memcmp(a.tangentImpulse, b.tangentImpulse, sizeof(a.tangentImpulse)) == 0);
+    }
+}
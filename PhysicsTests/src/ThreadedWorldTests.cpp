@@ -0,0 +1,95 @@
+#include <PhysicsWorld.hpp>
+#include <Scene.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+
+entt::entity addBox(Scene& scene, const glm::vec3& position)
+{
+    entt::registry& reg = scene.GetRegistry();
+    entt::entity entity = reg.create();
+    reg.emplace<Transform>(entity, position);
+    RigidBodyDesc desc;
+    desc.position = position;
+    reg.emplace<RigidBody>(entity, desc);
+    ColliderDesc collider;
+    collider.size = glm::vec3(1.0f);
+    reg.emplace<Collider>(entity, collider);
+    return entity;
+}
+
+// Runs frames on the main thread until done() holds or a few seconds pass
+template<typename Done>
+bool runFramesUntil(PhysicsWorld& world, Done done)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        world.update(0.0f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("The physics thread publishes transforms and takes teleports", "[PhysicsWorld]")
+{
+    Scene scene;
+    PhysicsWorld world(&scene);
+    world.setThreadCount(2);
+    world.setTickRate(240.0f);
+    entt::registry& reg = scene.GetRegistry();
+
+    entt::entity falling = addBox(scene, glm::vec3(0.0f, 5.0f, 0.0f));
+    entt::entity resting = addBox(scene, glm::vec3(10.0f, -4.5f, 0.0f));
+
+    world.setThreaded(true);
+    REQUIRE(world.isThreaded());
+
+    // Only update() writes Transform, from what the thread published
+    CHECK(runFramesUntil(world, [&] { return reg.get<Transform>(falling).position.y < 4.0f; }));
+
+    // Moved on the main thread, the body is sent there and Transform isn't pulled back
+    reg.get<Transform>(resting).position = glm::vec3(-10.0f, 0.0f, 0.0f);
+    CHECK(runFramesUntil(world, [&] {
+        auto lock = world.lockScene();
+        return reg.get<RigidBody>(resting).position.x < -9.0f;
+        }));
+    world.update(0.0f);
+    CHECK(reg.get<Transform>(resting).position.x < -9.0f);
+
+    // Stopping hands Transform back to the calling thread
+    world.setThreaded(false);
+    CHECK_FALSE(world.isThreaded());
+    reg.get<RigidBody>(falling).velocity = glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::vec3 before = reg.get<RigidBody>(falling).position;
+    world.stepSimulation(1.0f / 60.0f);
+    CHECK(reg.get<RigidBody>(falling).position != before);
+}
+
+TEST_CASE("Worlds destroyed with their thread running shut down cleanly", "[PhysicsWorld]")
+{
+    Scene scene;
+    entt::entity ground = addBox(scene, glm::vec3(0.0f, -4.5f, 0.0f));
+    addBox(scene, glm::vec3(0.0f, 2.0f, 0.0f));
+
+    // Short lives so the thread is caught at different points of its tick
+    for (int i = 0; i < 20; ++i) {
+        auto world = std::make_unique<PhysicsWorld>(&scene);
+        world->setThreadCount(2);
+        world->setThreaded(true);
+        world->update(0.0f);
+        if (i % 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(i));
+        }
+        world.reset();
+    }
+
+    // No destroy handler of a dead world is left behind
+    scene.GetRegistry().destroy(ground);
+    CHECK(scene.GetRegistry().view<RigidBody>().size() == 1);
+}
@@ -0,0 +1,61 @@
+#include <TaskPool.hpp>
+#include <TriangleMesh.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<glm::vec3> quadVertices()
+{
+    return { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+}
+
+} // namespace
+
+TEST_CASE("Mesh builds finish on the task pool", "[TriangleMesh]")
+{
+    TaskPool pool(2);
+    TriangleMeshFuture future = TriangleMesh::buildAsync(pool, quadVertices(), { 0, 1, 2, 0, 2, 3 });
+    REQUIRE(future.valid());
+
+    future.wait();
+    REQUIRE(future.isReady());
+    CHECK(future.get()->getTriangleCount() == 2);
+
+    // Copies share the result
+    TriangleMeshFuture copy = future;
+    CHECK(copy.get() == future.get());
+}
+
+TEST_CASE("Dropping every handle cancels a queued build without waiting", "[TriangleMesh]")
+{
+    TaskPool pool(2);
+
+    // Keep both workers busy so the build stays queued
+    std::atomic<bool> release{ false };
+    std::atomic<int> blocked{ 0 };
+    for (int i = 0; i < 2; ++i) {
+        pool.submit([&] {
+            ++blocked;
+            while (!release) std::this_thread::yield();
+            });
+    }
+    while (blocked < 2) std::this_thread::yield();
+
+    std::atomic<int> built{ 0 };
+    {
+        TriangleMeshFuture dropped = TriangleMesh::buildAsync(pool, [&] {
+            ++built;
+            return std::shared_ptr<const TriangleMesh>();
+            });
+        CHECK_FALSE(dropped.isReady());
+    }
+
+    // Queued behind the dropped build, so the workers have reached it once this is done
+    TriangleMeshFuture marker = TriangleMesh::buildAsync(pool, quadVertices(), { 0, 1, 2 });
+    release = true;
+    marker.wait();
+    CHECK(built == 0);
+}
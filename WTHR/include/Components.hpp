@@ -71,6 +71,15 @@ public:
 		return isLoaded;
 	}
 
+	// Calls func(const Model&) under the lock, false while nothing is loaded
+	template<typename Func>
+	bool Visit(Func&& func) {
+		std::lock_guard<std::mutex> lock(modelMutex);
+		if (!model || !isLoaded) return false;
+		func(*model);
+		return true;
+	}
+
 	void Reset() {
 		std::lock_guard<std::mutex> lock(modelMutex);
 		model.reset();
@@ -87,28 +96,19 @@ private:
 struct ModelComponent {
     std::shared_ptr<ThreadSafeModel> model;
 };
+// Driven by PhysicsWorld::updateCharacters() as an upright capsule
 struct PlayerController {
-	glm::vec3 velocity;      
-	glm::vec3 halfExtents;   
+	glm::vec3 velocity{ 0.0f };
+	glm::vec3 halfExtents{ 0.4f, 1.0f, 0.4f }; // capsule radius is the larger of x and z
 	bool isGrounded = false; 
 	float moveSpeed = 5.0f;  
 	float jumpForce = 10.0f; 
+
+	// Input for the next update, moveInput is a horizontal direction scaled by moveSpeed
+	glm::vec3 moveInput{ 0.0f };
+	bool jumpRequested = false;
 };
 struct GroupComponent
 {
 	int id;
 };
-struct Bullet {
-	Bullet(glm::vec3 pos, glm::vec3 vec, float ra, bool ac)
-	{
-		position = pos;
-		velocity = vec * bulletSpeed;
-		radius = ra;
-		active = ac;
-	}
-	glm::vec3 position;
-	glm::vec3 velocity;
-	float bulletSpeed = 10.f;
-	float radius;
-	bool active;
-};
\ No newline at end of file
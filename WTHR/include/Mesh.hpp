@@ -32,6 +32,8 @@ public:
 
     // Render the mesh
     void Draw(Shader& shader);
+    // Render instanceCount copies, instanceBuffer holds one vec4 per copy (location 7)
+    void DrawInstanced(Shader& shader, unsigned int instanceBuffer, unsigned int instanceCount);
 
     // Mesh data
     std::vector<Vertex> vertices;
@@ -22,6 +22,7 @@ public:
 
 	void Draw(Shader& shader);
 	std::string getDirectory() { return directory; }
+	const std::vector<Mesh>& getMeshes() const { return meshes; }
 private:
 	std::vector<Texture> textures_loaded;
 	std::vector<Mesh> meshes;
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+struct ProjectileDesc {
+	glm::vec3 position{ 0.0f };
+	glm::vec3 velocity{ 0.0f };
+	float radius = 0.1f;
+	float lifetime = 3.0f;            // seconds until the projectile expires
+	entt::entity owner = entt::null;  // reported as entityA of hit events
+	uint32_t layer = 1u;              // collision layer bits, see Collider
+	uint32_t mask = 0xFFFFFFFFu;      // layers the projectile can hit
+};
+
+// Fixed-capacity store for swept bullets. Live projectiles are packed at the
+// front of the arrays (swap-remove), one array per field so the sweep streams
+// through them. Nothing is allocated after setCapacity(): spawning into a
+// full pool replaces the projectile closest to expiry.
+//
+// All projectiles share one sphere mesh, the renderer draws them in a single
+// instanced call from getRenderInstances(). That list belongs to the main
+// thread, PhysicsWorld fills it after each step (or from its snapshot when
+// threaded), so drawing never reads the simulation arrays.
+class ProjectilePool {
+public:
+	explicit ProjectilePool(size_t capacity = 1024) { setCapacity(capacity); }
+
+	// Drops every live projectile
+	void setCapacity(size_t capacity);
+	size_t getCapacity() const { return m_capacity; }
+	size_t size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+
+	// Returns the slot, only valid until the next spawn or release
+	size_t spawn(const ProjectileDesc& desc);
+	// Moves the last projectile into index
+	void release(size_t index);
+	void clear() { m_count = 0; }
+	// Live projectiles as plain records in slot order, for snapshots
+	void save(std::vector<ProjectileDesc>& records) const;
+	// Replaces the live projectiles with records, in the same slots. Keeps
+	// the capacity, records past it are dropped.
+	void load(const std::vector<ProjectileDesc>& records);
+
+	// Copies position and radius of every live projectile
+	void writeInstances(std::vector<glm::vec4>& instances) const;
+	std::vector<glm::vec4>& getRenderInstances() { return m_renderInstances; }
+	const std::vector<glm::vec4>& getRenderInstances() const { return m_renderInstances; }
+
+	size_t getMemoryUsage() const;
+
+	// --- SoA data, [0, size()) is live ---
+	std::vector<float> px, py, pz;
+	std::vector<float> vx, vy, vz;
+	std::vector<float> radius;
+	std::vector<float> lifetime;     // seconds left
+	std::vector<entt::entity> owner;
+	std::vector<uint32_t> layer;
+	std::vector<uint32_t> mask;
+
+private:
+	size_t m_capacity = 0;
+	size_t m_count = 0;
+	std::vector<glm::vec4> m_renderInstances; // xyz position, w radius
+};
@@ -24,6 +24,8 @@ public:
     void DrawTriangle(const glm::vec3& color);
     void RenderScene(Scene&,Shader& );
     void RenderGizmo(Scene& scene, Shader& shader);
+    // Every live projectile in one instanced draw of the shared sphere
+    void RenderProjectiles(Scene& scene, const glm::mat4& view, const glm::mat4& projection);
     glm::mat4 BuildModelMatrix(const Transform& transform);
 
     void RenderPicking(Scene&,int,int);
@@ -41,6 +43,12 @@ private:
 
     float width, height;
     Shader pickingShader;
+
+    // Projectiles, unit sphere scaled per instance
+    Shader projectileShader;
+    std::unique_ptr<Shapes::Sphere> m_ProjectileMesh;
+    GLuint m_ProjectileInstanceVBO = 0;
+    size_t m_ProjectileInstanceCapacity = 0; // vec4s the buffer holds
     GLuint CompileShader(const std::string& source, GLenum type);
     void CreateShaderProgram();
 };
@@ -9,6 +9,7 @@
 #include "Model.hpp"
 #include <GLContextWorker.hpp>
 #include "Camera.hpp"
+#include "ProjectilePool.hpp"
 
 enum class CameraType {
 	Player,
@@ -18,13 +19,17 @@ enum class CameraType {
 
 class Scene {
 public:
-	Scene(GLFWwindow* window) : worker(window)
+	Scene(GLFWwindow* window) : worker(std::make_unique<GLContextWorker>(window))
 	{
 		spdlog::set_level(spdlog::level::debug);
 		spdlog::set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
 
 
 
+	}
+	// Headless scene without a GPU worker, for tools and benchmarks. Models can't be loaded.
+	Scene()
+	{
 	}
 	void print_transform(const Transform& t) {
 		std::cout << "Position: (" << t.position.x << ", " << t.position.y << ", " << t.position.z << ")\n";
@@ -118,14 +123,16 @@ public:
 		auto& mesh = m_Registry.emplace<MeshComponent>(entity, std::make_shared<Shapes::Sphere>(0.5f, 36, 18));
 		return entity;
 	}
-	entt::entity CreateBullet() {
-		auto entity = m_Registry.create();
-		m_Registry.emplace<Transform>(entity, GetCamera().Position);
-		m_Registry.emplace<Color>(entity, glm::vec4(1.f));
-		m_Registry.emplace<Bullet>(entity, GetCamera().Position,GetCamera().Front,0.1f,true);
-		m_Registry.emplace<MeshComponent>(entity, std::make_shared<Shapes::Sphere>(0.1f, 36, 18));
-		return entity;
+	// Fires a pooled projectile from the current camera, no entity or mesh is created
+	size_t CreateBullet(entt::entity owner = entt::null) {
+		Camera& camera = GetCamera();
+		ProjectileDesc desc;
+		desc.position = camera.Position;
+		desc.velocity = camera.Front * 10.f;
+		desc.owner = owner;
+		return m_Projectiles.spawn(desc);
 	}
+	ProjectilePool& GetProjectiles() { return m_Projectiles; }
 
 	// -------------------------
 	// Helper to create a model (async)
@@ -147,7 +154,12 @@ public:
 		modelWrapper->Reset();
 
 		// Queue asynchronous GPU load
-		worker.AsyncLoadModel(modelWrapper, path);
+		if (worker) {
+			worker->AsyncLoadModel(modelWrapper, path);
+		}
+		else {
+			spdlog::warn("Headless scene, model {} was not loaded", path);
+		}
 
 
 		return entity;
@@ -171,11 +183,12 @@ public:
 	T& AddComponent(entt::entity entity, Args&&... args) {
 		return m_Registry.emplace<T>(entity, std::forward<Args>(args)...);
 	}
-	GLContextWorker worker;
+	std::unique_ptr<GLContextWorker> worker; // null in a headless scene
 	Script script;
 private:
 	std::unordered_map<std::string, Texture> m_Textures; // path or name → texture data
 	entt::registry m_Registry;
+	ProjectilePool m_Projectiles;
 	Camera m_Camera;
 	CameraType m_CameraType = CameraType::Editor;
 };
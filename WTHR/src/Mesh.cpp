@@ -191,6 +191,30 @@ void Mesh::Draw(Shader& shader) {
 	glActiveTexture(GL_TEXTURE0);
 }
 
+void Mesh::DrawInstanced(Shader& shader, unsigned int instanceBuffer, unsigned int instanceCount) {
+	if (instanceCount == 0) return;
+
+	uintptr_t contextID = reinterpret_cast<uintptr_t>(glfwGetCurrentContext());
+
+	if (VAOs.find(contextID) == VAOs.end())
+		setupMeshForContext(contextID);
+	unsigned int VAO = VAOs[contextID];
+
+	glBindVertexArray(VAO);
+	glUseProgram(shader.ID);
+
+	// Per instance data, stepped once per copy
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+	glVertexAttribDivisor(7, 1);
+
+	glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0, static_cast<GLsizei>(instanceCount));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 //----------------------//
 // Setup Mesh
 //----------------------//
@@ -0,0 +1,107 @@
+#include "ProjectilePool.hpp"
+#include <algorithm>
+
+void ProjectilePool::setCapacity(size_t capacity)
+{
+	m_capacity = capacity;
+	m_count = 0;
+
+	px.assign(capacity, 0.0f);
+	py.assign(capacity, 0.0f);
+	pz.assign(capacity, 0.0f);
+	vx.assign(capacity, 0.0f);
+	vy.assign(capacity, 0.0f);
+	vz.assign(capacity, 0.0f);
+	radius.assign(capacity, 0.0f);
+	lifetime.assign(capacity, 0.0f);
+	owner.assign(capacity, entt::null);
+	layer.assign(capacity, 0u);
+	mask.assign(capacity, 0u);
+
+	m_renderInstances.clear();
+	m_renderInstances.reserve(capacity);
+}
+
+size_t ProjectilePool::spawn(const ProjectileDesc& desc)
+{
+	if (m_capacity == 0) return 0;
+
+	size_t index = m_count;
+	if (m_count < m_capacity) {
+		++m_count;
+	}
+	else {
+		// Full, recycle the one that would expire first
+		index = static_cast<size_t>(std::min_element(lifetime.begin(), lifetime.begin() + m_count) - lifetime.begin());
+	}
+
+	px[index] = desc.position.x;
+	py[index] = desc.position.y;
+	pz[index] = desc.position.z;
+	vx[index] = desc.velocity.x;
+	vy[index] = desc.velocity.y;
+	vz[index] = desc.velocity.z;
+	radius[index] = desc.radius;
+	lifetime[index] = desc.lifetime;
+	owner[index] = desc.owner;
+	layer[index] = desc.layer;
+	mask[index] = desc.mask;
+	return index;
+}
+
+void ProjectilePool::release(size_t index)
+{
+	size_t last = --m_count;
+	if (index == last) return;
+
+	px[index] = px[last];
+	py[index] = py[last];
+	pz[index] = pz[last];
+	vx[index] = vx[last];
+	vy[index] = vy[last];
+	vz[index] = vz[last];
+	radius[index] = radius[last];
+	lifetime[index] = lifetime[last];
+	owner[index] = owner[last];
+	layer[index] = layer[last];
+	mask[index] = mask[last];
+}
+
+void ProjectilePool::save(std::vector<ProjectileDesc>& records) const
+{
+	records.resize(m_count);
+	for (size_t i = 0; i < m_count; ++i) {
+		ProjectileDesc& record = records[i];
+		record.position = glm::vec3(px[i], py[i], pz[i]);
+		record.velocity = glm::vec3(vx[i], vy[i], vz[i]);
+		record.radius = radius[i];
+		record.lifetime = lifetime[i];
+		record.owner = owner[i];
+		record.layer = layer[i];
+		record.mask = mask[i];
+	}
+}
+
+void ProjectilePool::load(const std::vector<ProjectileDesc>& records)
+{
+	// Filling from empty never recycles, so record i lands in slot i
+	m_count = 0;
+	size_t count = std::min(records.size(), m_capacity);
+	for (size_t i = 0; i < count; ++i) {
+		spawn(records[i]);
+	}
+}
+
+void ProjectilePool::writeInstances(std::vector<glm::vec4>& instances) const
+{
+	instances.resize(m_count);
+	for (size_t i = 0; i < m_count; ++i) {
+		instances[i] = glm::vec4(px[i], py[i], pz[i], radius[i]);
+	}
+}
+
+size_t ProjectilePool::getMemoryUsage() const
+{
+	return m_capacity * (8 * sizeof(float) + sizeof(entt::entity) + 2 * sizeof(uint32_t))
+		+ m_renderInstances.capacity() * sizeof(glm::vec4);
+}
@@ -49,6 +49,11 @@ void Renderer::Init()
 
 	pickingShader = Shader("shaders/picking.vert", "shaders/picking.frag");
 
+	// One low poly sphere for every bullet
+	projectileShader = Shader("shaders/projectile.vert", "shaders/projectile.frag");
+	m_ProjectileMesh = std::make_unique<Shapes::Sphere>(1.0f, 12, 8);
+	glGenBuffers(1, &m_ProjectileInstanceVBO);
+
 	// In your main application initialization
 
 }
@@ -165,10 +170,35 @@ void Renderer::RenderScene(Scene& scene, Shader& shader)
 		modelComp.model.get()->Draw(shader);
 		});
 
+	RenderProjectiles(scene, view, projection);
+
 	// Render Gizmo if needed (consider separating this into its own function)
 	RenderGizmo(scene, shader);
 }
 
+void Renderer::RenderProjectiles(Scene& scene, const glm::mat4& view, const glm::mat4& projection)
+{
+	const std::vector<glm::vec4>& instances = scene.GetProjectiles().getRenderInstances();
+	if (instances.empty() || !m_ProjectileMesh) return;
+
+	// Sized for the whole pool, so the buffer is only reallocated if the capacity changes
+	glBindBuffer(GL_ARRAY_BUFFER, m_ProjectileInstanceVBO);
+	size_t capacity = std::max(scene.GetProjectiles().getCapacity(), instances.size());
+	if (capacity != m_ProjectileInstanceCapacity) {
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+		m_ProjectileInstanceCapacity = capacity;
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(glm::vec4), instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	projectileShader.use();
+	projectileShader.setMat4("view", view);
+	projectileShader.setMat4("projection", projection);
+	projectileShader.setVec4("uColor", glm::vec4(1.f));
+
+	m_ProjectileMesh->mesh.DrawInstanced(projectileShader, m_ProjectileInstanceVBO, static_cast<unsigned int>(instances.size()));
+}
+
 // Helper function for building model matrices
 glm::mat4 Renderer::BuildModelMatrix(const Transform& transform)
 {
@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 7) in vec4 aInstance; // xyz position, w radius
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    vec3 worldPos = aInstance.xyz + aPos * aInstance.w;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}